@@ -0,0 +1,45 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+// Tiny timing helpers shared by the benchmark executable.
+// Build with -DCMAKE_BUILD_TYPE=Release for meaningful numbers.
+
+// Run fn() `iterations` times after one warm-up call and return nanoseconds per call
+template <typename Fn>
+double measureNs(int iterations, Fn&& fn) {
+    fn();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        fn();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+// Keep a result the timed work accumulated, so the compiler cannot drop that work
+inline volatile uint64_t benchmarkSink = 0;
+template <typename T>
+void doNotOptimize(const T& value) {
+    benchmarkSink = static_cast<uint64_t>(value);
+}
+
+inline void printResult(const char* name, double nsPerOp) {
+    std::printf("  %-44s %12.1f ns/op\n", name, nsPerOp);
+}
+
+inline void printSpeedup(const char* name, double baselineNs, double optimizedNs) {
+    std::printf("  %-44s %12.2fx\n", name, baselineNs / optimizedNs);
+}
+
+// Benchmark groups, one per source file
+void runChunkBenchmarks();
+void runColdCacheBenchmarks();
+void runOctreeBenchmarks();
+void runLightBenchmarks();
+void runStreamingBenchmarks();
+void runEditJournalBenchmarks();
+void runRaycastBenchmarks();
+void runBoxReadBenchmarks();
+void runConcurrentMapBenchmarks();
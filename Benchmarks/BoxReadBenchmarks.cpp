@@ -0,0 +1,63 @@
+#include "Benchmark.h"
+#include "Resources/Classes/World.h"
+#include "Resources/Classes/WorldGeneration.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Update until the workers are idle, so they do not compete with the reads being timed
+    void settle(World& world, const glm::vec3& center) {
+        for (;;) {
+            world.update(center);
+            const StreamingStats stats = world.getStreamingStats();
+            if (stats.generating == 0 && stats.meshing == 0 && stats.uploadsWaiting == 0) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // The same box through World::getBlockGlobal, one chunk lookup per voxel
+    void blockByBlock(const World& world, const glm::ivec3& min, const glm::ivec3& max, std::vector<Block>& out) {
+        size_t i = 0;
+        for (int y = min.y; y < max.y; y++) {
+            for (int z = min.z; z < max.z; z++) {
+                for (int x = min.x; x < max.x; x++) out[i++] = world.getBlockGlobal(x, y, z);
+            }
+        }
+    }
+
+    void compare(const World& world, const glm::ivec3& min, const glm::ivec3& max, int iterations, const char* name) {
+        const glm::ivec3 size = max - min;
+        std::vector<Block> out(static_cast<size_t>(size.x) * size.y * size.z);
+        int solid = 0;
+        const double fastNs = measureNs(iterations, [&] {
+            const BlockRegionView view = world.readRegion(min, max, out);
+            solid += view.at(size.x / 2, size.y / 2, size.z / 2).isSolid();
+        });
+        const double slowNs = measureNs(iterations, [&] {
+            blockByBlock(world, min, max, out);
+            solid += out[out.size() / 2].isSolid();
+        });
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s (readRegion)", name);
+        printResult(label, fastNs);
+        std::snprintf(label, sizeof(label), "%s (getBlockGlobal)", name);
+        printResult(label, slowNs);
+        printSpeedup("speedup", slowNs, fastNs);
+        doNotOptimize(solid);
+    }
+}
+
+void runBoxReadBenchmarks() {
+    std::printf("Box reads\n");
+
+    WorldGeneration::initialize(1337);
+    World world(4);
+    const glm::vec3 center(8.0f, 10.0f, 8.0f);
+    settle(world, center);
+
+    // Unaligned so every chunk of the box is cut on some side
+    compare(world, {-37, 0, -29}, {59, CHUNK_HEIGHT, 67}, 200, "96x16x96 box across 49 chunks");
+    compare(world, {5, 2, 3}, {11, 9, 13}, 200000, "6x7x10 box inside one chunk");
+}
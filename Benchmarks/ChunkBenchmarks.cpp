@@ -0,0 +1,127 @@
+#include "Benchmark.h"
+#include "Resources/Classes/Chunk.h"
+#include "Resources/Classes/ChunkGrid.h"
+#include "Resources/Classes/ChunkMesher.h"
+#include "Resources/Classes/World.h"
+#include "Resources/Classes/WorldGeneration.h"
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+void runChunkBenchmarks() {
+    std::printf("Chunk writes\n");
+
+    WorldGeneration::initialize(1337);
+    Chunk chunk(glm::ivec2(0, 0));
+
+    // The same full-chunk write done voxel by voxel and through the bulk entry points
+    const double perVoxel = measureNs(2000, [&] {
+        for (int x = 0; x < CHUNK_SIZE; x++)
+            for (int z = 0; z < CHUNK_SIZE; z++)
+                for (int y = 0; y < CHUNK_HEIGHT; y++)
+                    chunk.setBlock(x, y, z, Block{y < 8 ? BlockType::STONE : BlockType::AIR});
+    });
+    const double columns = measureNs(2000, [&] {
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            for (int z = 0; z < CHUNK_SIZE; z++) {
+                chunk.fillColumn(x, z, 0, 8, Block{BlockType::STONE});
+                chunk.fillColumn(x, z, 8, CHUNK_HEIGHT, Block{BlockType::AIR});
+            }
+        }
+    });
+    const double boxes = measureNs(2000, [&] {
+        chunk.fillBox({0, 0, 0}, {CHUNK_SIZE, 8, CHUNK_SIZE}, Block{BlockType::STONE});
+        chunk.fillBox({0, 8, 0}, {CHUNK_SIZE, CHUNK_HEIGHT, CHUNK_SIZE}, Block{BlockType::AIR});
+    });
+    const double span = measureNs(2000, [&] {
+        Chunk::BlockEdit edit = chunk.editBlocks();
+        for (int s = 0; s < CHUNK_SECTIONS; s++) {
+            std::span<Block, SECTION_VOLUME> blocks = edit.section(s);
+            for (int y = 0; y < SECTION_HEIGHT; y++)
+                for (int z = 0; z < CHUNK_SIZE; z++)
+                    for (int x = 0; x < CHUNK_SIZE; x++)
+                        blocks[Chunk::blockIndex(x, y, z)] = Block{s * SECTION_HEIGHT + y < 8 ? BlockType::STONE : BlockType::AIR};
+        }
+    });
+
+    printResult("setBlock x4096", perVoxel);
+    printResult("fillColumn x512", columns);
+    printResult("fillBox x2", boxes);
+    printResult("editBlocks span x4096", span);
+    printSpeedup("span vs setBlock", perVoxel, span);
+
+    // Writing while a snapshot is held pays for one section copy, once
+    const double snapshotTake = measureNs(20000, [&] {
+        ChunkSnapshot snap = chunk.snapshot();
+    });
+    const double writeAfterSnapshot = measureNs(2000, [&] {
+        ChunkSnapshot snap = chunk.snapshot();
+        chunk.setBlock(1, 1, 1, Block{BlockType::DIRT});
+    });
+    printResult("snapshot", snapshotTake);
+    printResult("snapshot + setBlock (section copy)", writeAfterSnapshot);
+
+    // Full generation, dominated by noise but now free of per-voxel write overhead
+    const double generate = measureNs(200, [&] {
+        WorldGeneration::generateChunk(chunk);
+    });
+    printResult("generateChunk", generate);
+
+    // Resident chunk lookup: the ring-buffer grid against the hash map it replaced
+    std::printf("Chunk index\n");
+    constexpr int RADIUS = 8;
+    ChunkGrid grid(RADIUS);
+    std::unordered_map<int64_t, Chunk*> map;
+    for (int x = -RADIUS; x <= RADIUS; x++) {
+        for (int z = -RADIUS; z <= RADIUS; z++) {
+            auto c = std::make_unique<Chunk>(glm::ivec2(x, z));
+            map[(static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(z)] = c.get();
+            grid.insert(std::move(c));
+        }
+    }
+
+    std::mt19937 rng(3);
+    std::vector<glm::ivec2> queries(4096);
+    for (glm::ivec2& q : queries) {
+        q = glm::ivec2(static_cast<int>(rng() % (2 * RADIUS + 1)) - RADIUS,
+                       static_cast<int>(rng() % (2 * RADIUS + 1)) - RADIUS);
+    }
+    size_t found = 0;
+    const double mapLookup = measureNs(200, [&] {
+        for (const glm::ivec2& q : queries) {
+            auto it = map.find((static_cast<int64_t>(q.x) << 32) | static_cast<uint32_t>(q.y));
+            found += it != map.end();
+        }
+    }) / queries.size();
+    const double gridLookup = measureNs(200, [&] {
+        for (const glm::ivec2& q : queries) {
+            found += grid.find(q.x, q.y) != nullptr;
+        }
+    }) / queries.size();
+    printResult("lookup (unordered_map)", mapLookup);
+    printResult("lookup (ChunkGrid)", gridLookup);
+    printSpeedup("grid vs map", mapLookup, gridLookup);
+    if (found == 0) std::printf("  (no chunks found)\n");
+
+    // Meshing reads a padded copy; the copy and the face loop are timed separately
+    std::printf("Meshing\n");
+    World world(0);
+    world.update(glm::vec3(0.0f, 10.0f, 0.0f));
+    Chunk* meshed = world.getChunk(0, 0);
+    const auto around = meshed->neighborhood(world);
+    auto padded = std::make_unique<PaddedChunk>();
+    std::vector<float> vertices;
+    const double gather = measureNs(2000, [&] {
+        padded->gather(around);
+    });
+    const double build = measureNs(2000, [&] {
+        ChunkMesher::buildMesh(*padded, vertices);
+    });
+    const double full = measureNs(2000, [&] {
+        meshed->generateMeshWithWorld(world);
+    });
+    printResult("PaddedChunk::gather", gather);
+    printResult("ChunkMesher::buildMesh", build);
+    printResult("generateMeshWithWorld", full);
+}
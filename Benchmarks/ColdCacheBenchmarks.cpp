@@ -0,0 +1,54 @@
+#include "Benchmark.h"
+#include "Resources/Classes/ChunkColdCache.h"
+#include "Resources/Classes/ChunkCompression.h"
+#include "Resources/Classes/World.h"
+#include "Resources/Classes/WorldGeneration.h"
+
+void runColdCacheBenchmarks() {
+    std::printf("Cold chunk tier\n");
+
+    WorldGeneration::initialize(1337);
+    World world(0);
+    Chunk chunk(glm::ivec2(3, -2));
+    WorldGeneration::generateChunk(chunk);
+
+    const std::vector<uint8_t> packed = ChunkCompression::compress(chunk.snapshot());
+    std::printf("  %-44s %12zu -> %zu bytes\n", "compressed size", sizeof(Block) * CHUNK_VOLUME, packed.size());
+
+    const double generate = measureNs(200, [&] {
+        WorldGeneration::generateChunk(chunk);
+    });
+    const double generateAndMesh = measureNs(200, [&] {
+        WorldGeneration::generateChunk(chunk);
+        chunk.generateMeshWithWorld(world);
+    });
+    const double compress = measureNs(2000, [&] {
+        ChunkCompression::compress(chunk.snapshot());
+    });
+    const double decompress = measureNs(2000, [&] {
+        ChunkCompression::decompress(packed, chunk);
+    });
+
+    printResult("generateChunk", generate);
+    printResult("generateChunk + mesh", generateAndMesh);
+    printResult("compress", compress);
+    printResult("decompress", decompress);
+    printSpeedup("decompress vs generateChunk", generate, decompress);
+
+    // Round trip through the cache with a cap that forces evictions, the way World does
+    // it: take the entry on the update thread, decompress it in the load job
+    ChunkColdCache cache(64 * 1024);
+    for (int i = 0; i < 512; i++) {
+        Chunk c(glm::ivec2(i, 0));
+        WorldGeneration::generateChunk(c);
+        cache.store(c);
+    }
+    int restored = 0;
+    std::vector<uint8_t> data;
+    for (int i = 0; i < 512; i++) {
+        Chunk c(glm::ivec2(i, 0));
+        if (cache.take(c.position, data) && ChunkCompression::decompress(data, c)) restored++;
+    }
+    std::printf("  %-44s %d restored, %zu evicted, hit rate %.0f%%\n", "64 KB cap, 512 chunks", restored,
+                static_cast<size_t>(cache.evictionCount()), cache.hitRate() * 100.0f);
+}
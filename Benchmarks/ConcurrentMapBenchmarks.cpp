@@ -0,0 +1,116 @@
+#include "Benchmark.h"
+#include "Resources/Classes/ConcurrentChunkMap.h"
+#include <atomic>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    constexpr int RADIUS = 16;
+    constexpr int LOOKUPS = 200000; // Per thread
+
+    // What the sharded map replaces: one shared_mutex around one hash map. Every lookup
+    // still writes the lock's reader count, so all readers share that cache line.
+    class SingleLockChunkMap {
+    public:
+        std::shared_ptr<const ChunkSnapshot> find(int cx, int cz) const {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = chunks.find(key(cx, cz));
+            return it != chunks.end() ? it->second : nullptr;
+        }
+        void publish(std::shared_ptr<const ChunkSnapshot> snapshot) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            chunks[key(snapshot->position.x, snapshot->position.y)] = std::move(snapshot);
+        }
+
+    private:
+        mutable std::shared_mutex mutex;
+        std::unordered_map<int64_t, std::shared_ptr<const ChunkSnapshot>> chunks;
+
+        static int64_t key(int cx, int cz) {
+            return (static_cast<int64_t>(cx) << 32) | static_cast<uint32_t>(cz);
+        }
+    };
+
+    // Nanoseconds per lookup across all threads, while one more thread republishes
+    // chunks the way the update thread does after edits
+    template <typename Map>
+    double lookups(Map& map, const std::vector<std::shared_ptr<const ChunkSnapshot>>& snapshots, int threads) {
+        std::atomic<bool> stop{false};
+        std::thread writer([&] {
+            size_t i = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                map.publish(snapshots[i++ % snapshots.size()]);
+                std::this_thread::yield();
+            }
+        });
+
+        std::atomic<size_t> found{0};
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> readers;
+        for (int t = 0; t < threads; t++) {
+            readers.emplace_back([&, t] {
+                // A mesher job's pattern: a chunk and its eight neighbors
+                std::mt19937 rng(t + 1);
+                std::uniform_int_distribution<int> coord(-RADIUS + 1, RADIUS - 1);
+                size_t hits = 0;
+                for (int i = 0; i < LOOKUPS / 9; i++) {
+                    const int cx = coord(rng);
+                    const int cz = coord(rng);
+                    for (int dz = -1; dz <= 1; dz++) {
+                        for (int dx = -1; dx <= 1; dx++) hits += map.find(cx + dx, cz + dz) != nullptr;
+                    }
+                }
+                found += hits;
+            });
+        }
+        for (std::thread& reader : readers) reader.join();
+        const auto end = std::chrono::steady_clock::now();
+        stop = true;
+        writer.join();
+
+        doNotOptimize(found.load());
+        return std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(threads) * (LOOKUPS / 9) * 9);
+    }
+}
+
+void runConcurrentMapBenchmarks() {
+    std::printf("Concurrent chunk lookups\n");
+
+    std::vector<std::shared_ptr<const ChunkSnapshot>> snapshots;
+    for (int x = -RADIUS; x <= RADIUS; x++) {
+        for (int z = -RADIUS; z <= RADIUS; z++) {
+            Chunk chunk(glm::ivec2(x, z));
+            snapshots.push_back(std::make_shared<const ChunkSnapshot>(chunk.snapshot()));
+        }
+    }
+    ConcurrentChunkMap sharded;
+    SingleLockChunkMap single;
+    for (const auto& snapshot : snapshots) {
+        sharded.publish(snapshot);
+        single.publish(snapshot);
+    }
+
+    // Up to twice the hardware threads, so every core has a reader
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> readerCounts = {1, 2, 4, 8, cores, 2 * cores};
+    std::sort(readerCounts.begin(), readerCounts.end());
+    readerCounts.erase(std::unique(readerCounts.begin(), readerCounts.end()), readerCounts.end());
+    std::printf("  %-44s %12d\n", "hardware threads", cores);
+
+    for (int threads : readerCounts) {
+        const double singleNs = lookups(single, snapshots, threads);
+        const double shardedNs = lookups(sharded, snapshots, threads);
+        char label[64];
+        std::snprintf(label, sizeof(label), "%d reader(s), one shared_mutex", threads);
+        printResult(label, singleNs);
+        std::snprintf(label, sizeof(label), "%d reader(s), %zu shards", threads, ConcurrentChunkMap::SHARDS);
+        printResult(label, shardedNs);
+        printSpeedup("speedup", singleNs, shardedNs);
+    }
+}
@@ -0,0 +1,133 @@
+#include "Benchmark.h"
+#include "Resources/Classes/ChunkCompression.h"
+#include "Resources/Classes/EditJournal.h"
+#include "Resources/Classes/WorldGeneration.h"
+#include <filesystem>
+#include <random>
+
+namespace {
+    constexpr int VISITED_SIDE = 32; // Chunks visited: one region
+
+    uint64_t directoryBytes(const std::filesystem::path& directory) {
+        uint64_t bytes = 0;
+        for (const auto& file : std::filesystem::directory_iterator(directory)) bytes += file.file_size();
+        return bytes;
+    }
+
+    // Edits clustered around a few chunks, the way a player builds
+    void recordEdits(EditJournal& journal, int count, std::mt19937& rng) {
+        std::uniform_int_distribution<int> chunk(0, 3);
+        std::uniform_int_distribution<int> index(0, CHUNK_VOLUME - 1);
+        std::uniform_int_distribution<int> type(0, 3);
+        for (int i = 0; i < count; i++) {
+            journal.record(glm::ivec2(chunk(rng), chunk(rng)), index(rng), Block{static_cast<BlockType>(type(rng))});
+        }
+    }
+}
+
+void runEditJournalBenchmarks() {
+    std::printf("Edit journal\n");
+
+    WorldGeneration::initialize(1337);
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "voxel-journal-benchmark";
+
+    // What saving every visited chunk in full would write
+    Chunk chunk(glm::ivec2(0, 0));
+    uint64_t fullChunkBytes = 0;
+    for (int z = 0; z < VISITED_SIDE; z++) {
+        for (int x = 0; x < VISITED_SIDE; x++) {
+            chunk.position = glm::ivec2(x, z);
+            WorldGeneration::generateChunk(chunk);
+            fullChunkBytes += ChunkCompression::compress(chunk.snapshot()).size();
+        }
+    }
+    std::printf("  %-44s %12.1f KB\n", "full saves, 1024 chunks visited", fullChunkBytes / 1024.0);
+
+    // The journal writes nothing for chunks that were only visited
+    std::mt19937 rng(7);
+    for (int edits : {0, 100, 1000, 100000}) {
+        std::filesystem::remove_all(directory);
+        EditJournalStats stats;
+        {
+            EditJournal journal(directory);
+            recordEdits(journal, edits, rng);
+            journal.flush();
+            if (journal.needsCompaction()) journal.compact();
+            stats = journal.getStats();
+        }
+        char name[64];
+        std::snprintf(name, sizeof(name), "journal, %d edits", edits);
+        std::printf("  %-44s %12.1f KB written, %.1f KB on disk, %llu compactions\n", name, stats.bytesWritten / 1024.0,
+                    directoryBytes(directory) / 1024.0, static_cast<unsigned long long>(stats.compactions));
+    }
+
+    // Per-edit and per-load costs
+    std::filesystem::remove_all(directory);
+    {
+        EditJournal journal(directory);
+        std::uniform_int_distribution<int> index(0, CHUNK_VOLUME - 1);
+        const double record = measureNs(100000, [&] {
+            journal.record(glm::ivec2(0, 0), index(rng), Block{BlockType::STONE});
+        });
+        journal.compact();
+        recordEdits(journal, 256, rng);
+
+        chunk.position = glm::ivec2(1, 1);
+        const double generate = measureNs(500, [&] {
+            WorldGeneration::generateChunk(chunk);
+        });
+        const double generateAndReplay = measureNs(500, [&] {
+            WorldGeneration::generateChunk(chunk);
+            journal.apply(chunk);
+        });
+        chunk.position = glm::ivec2(8, 8);
+        const double untouched = measureNs(500, [&] {
+            WorldGeneration::generateChunk(chunk);
+            journal.apply(chunk);
+        });
+
+        printResult("record", record);
+        printResult("generateChunk", generate);
+        printResult("generateChunk + replay, edited chunk", generateAndReplay);
+        printResult("generateChunk + replay, untouched chunk", untouched);
+    }
+
+    // The load path that replaced reading full chunks from region files: every chunk of a
+    // region edited, folded into the region files, and the journal reopened so that each
+    // load generates the chunk and replays its delta list from disk
+    constexpr int EDITS_PER_CHUNK = 64;
+    std::filesystem::remove_all(directory);
+    {
+        EditJournal journal(directory);
+        std::uniform_int_distribution<int> index(0, CHUNK_VOLUME - 1);
+        for (int z = 0; z < VISITED_SIDE; z++) {
+            for (int x = 0; x < VISITED_SIDE; x++) {
+                for (int i = 0; i < EDITS_PER_CHUNK; i++) journal.record(glm::ivec2(x, z), index(rng), Block{BlockType::STONE});
+            }
+        }
+        journal.compact();
+    }
+    double generateSeconds = 0.0;
+    double loadSeconds = 0.0;
+    {
+        EditJournal journal(directory);
+        for (int z = 0; z < VISITED_SIDE; z++) {
+            for (int x = 0; x < VISITED_SIDE; x++) {
+                chunk.position = glm::ivec2(x, z);
+                auto start = std::chrono::steady_clock::now();
+                WorldGeneration::generateChunk(chunk);
+                generateSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                start = std::chrono::steady_clock::now();
+                WorldGeneration::generateChunk(chunk);
+                journal.apply(chunk);
+                loadSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+        }
+    }
+    const double chunks = VISITED_SIDE * VISITED_SIDE;
+    std::printf("  %-44s %12.0f chunks/s\n", "generateChunk", chunks / generateSeconds);
+    std::printf("  %-44s %12.0f chunks/s\n", "load: generate + replay 64 deltas from disk", chunks / loadSeconds);
+    printSpeedup("load speed vs bare generateChunk", generateSeconds, loadSeconds);
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,48 @@
+#include "Benchmark.h"
+#include "Resources/Classes/LightEngine.h"
+#include "Resources/Classes/World.h"
+#include "Resources/Classes/WorldGeneration.h"
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+void runLightBenchmarks() {
+    std::printf("Lighting\n");
+
+    WorldGeneration::initialize(1337);
+    Chunk chunk(glm::ivec2(0, 0));
+    WorldGeneration::generateChunk(chunk);
+    const ChunkSnapshot snapshot = chunk.snapshot();
+    std::array<uint8_t, CHUNK_VOLUME> light;
+    const double single = measureNs(500, [&] {
+        LightEngine::computeChunkLight(snapshot, light);
+    });
+    printResult("computeChunkLight", single);
+
+    // Incremental relighting after single-block edits in a loaded world. Without worker
+    // threads the first update loads the whole render distance.
+    World world(0);
+    world.update(glm::vec3(0.0f, 10.0f, 0.0f));
+    const LightStats loadStats = world.getLightStats();
+    std::printf("  %-44s %12.1f us avg, %.1f us max\n", "chunk border stitching",
+                loadStats.averageMicros(), loadStats.maxMicros);
+
+    std::mt19937 rng(7);
+    const uint64_t updatesBefore = loadStats.updates;
+    const uint64_t nodesBefore = loadStats.nodesVisited;
+    const double totalBefore = loadStats.totalMicros;
+    for (int i = 0; i < 2000; i++) {
+        const int x = static_cast<int>(rng() % 128) - 64;
+        const int z = static_cast<int>(rng() % 128) - 64;
+        const int y = std::min(world.getSurfaceHeight(x, z) + 2, CHUNK_HEIGHT - 1);
+        // A floating block shades the column under it; removing it lets the sky back in
+        world.setBlockGlobal(x, y, z, Block{BlockType::STONE});
+        world.setBlockGlobal(x, y, z, Block{BlockType::AIR});
+    }
+    const LightStats& editStats = world.getLightStats();
+    const uint64_t edits = editStats.updates - updatesBefore;
+    std::printf("  %-44s %12.1f us avg, %llu nodes avg\n", "block edit relight",
+                (editStats.totalMicros - totalBefore) / edits,
+                static_cast<unsigned long long>((editStats.nodesVisited - nodesBefore) / edits));
+}
@@ -0,0 +1,105 @@
+#include "Benchmark.h"
+#include "Resources/Classes/VoxelOctree.h"
+#include "Resources/Classes/WorldGeneration.h"
+#include <memory>
+#include <random>
+#include <unordered_map>
+
+namespace {
+    constexpr int GRID = 16; // GRID x GRID chunks
+
+    int64_t chunkKey(int x, int z) {
+        return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(z);
+    }
+}
+
+void runOctreeBenchmarks() {
+    std::printf("Far-field octree (%dx%d chunks)\n", GRID, GRID);
+
+    WorldGeneration::initialize(1337);
+    std::unordered_map<int64_t, std::unique_ptr<Chunk>> chunks;
+    VoxelOctree octree(10);
+    for (int x = -GRID / 2; x < GRID / 2; x++) {
+        for (int z = -GRID / 2; z < GRID / 2; z++) {
+            auto chunk = std::make_unique<Chunk>(glm::ivec2(x, z));
+            WorldGeneration::generateChunk(*chunk);
+            octree.insertChunk(chunk->snapshot());
+            chunks[chunkKey(x, z)] = std::move(chunk);
+        }
+    }
+    octree.compact();
+
+    // Same lookup World::getBlockGlobal does against its unordered_map
+    auto mapLookup = [&](int gx, int gy, int gz) -> BlockType {
+        if (gy < 0 || gy >= CHUNK_HEIGHT) return BlockType::AIR;
+        const int cx = floorDiv(gx, CHUNK_SIZE);
+        const int cz = floorDiv(gz, CHUNK_SIZE);
+        auto it = chunks.find(chunkKey(cx, cz));
+        if (it == chunks.end()) return BlockType::AIR;
+        return it->second->getBlock(gx - cx * CHUNK_SIZE, gy, gz - cz * CHUNK_SIZE).type;
+    };
+
+    const int extent = GRID / 2 * CHUNK_SIZE;
+    int mismatches = 0;
+    for (int gx = -extent; gx < extent; gx++)
+        for (int gz = -extent; gz < extent; gz++)
+            for (int gy = 0; gy < CHUNK_HEIGHT; gy++)
+                if (octree.getBlock(gx, gy, gz) != mapLookup(gx, gy, gz)) mismatches++;
+
+    const size_t flatBytes = chunks.size() * CHUNK_VOLUME * sizeof(Block);
+    std::printf("  %-44s %12zu nodes, %zu bytes (flat %zu bytes), %d mismatches\n", "size on disk",
+                octree.nodeCount(), octree.serializedSize(), flatBytes, mismatches);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> coord(-extent, extent - 1);
+    std::uniform_int_distribution<int> height(0, CHUNK_HEIGHT - 1);
+    std::vector<glm::ivec3> points(4096);
+    for (auto& p : points) p = glm::ivec3(coord(rng), height(rng), coord(rng));
+
+    int sink = 0;
+    const double octreePoint = measureNs(200, [&] {
+        for (const auto& p : points) sink += static_cast<int>(octree.getBlock(p.x, p.y, p.z));
+    }) / points.size();
+    const double mapPoint = measureNs(200, [&] {
+        for (const auto& p : points) sink += static_cast<int>(mapLookup(p.x, p.y, p.z));
+    }) / points.size();
+    printResult("point query (octree)", octreePoint);
+    printResult("point query (unordered_map)", mapPoint);
+
+    const double octreeBox = measureNs(200, [&] {
+        for (int i = 0; i < 256; i++) {
+            const glm::ivec3& p = points[i];
+            sink += octree.anySolid(p, p + glm::ivec3(8, 4, 8));
+        }
+    }) / 256;
+    const double mapBox = measureNs(200, [&] {
+        for (int i = 0; i < 256; i++) {
+            const glm::ivec3& p = points[i];
+            bool solid = false;
+            for (int y = p.y; y < p.y + 4 && !solid; y++)
+                for (int z = p.z; z < p.z + 8 && !solid; z++)
+                    for (int x = p.x; x < p.x + 8 && !solid; x++)
+                        solid = BlockRegistry::isSolid(mapLookup(x, y, z));
+            sink += solid;
+        }
+    }) / 256;
+    printResult("8x4x8 box query (octree)", octreeBox);
+    printResult("8x4x8 box query (unordered_map)", mapBox);
+
+    // Long, shallow rays skimming the terrain
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::vector<std::pair<glm::vec3, glm::vec3>> rays(1024);
+    for (auto& [o, d] : rays) {
+        const float a = angle(rng);
+        o = glm::vec3(coord(rng) * 0.5f, CHUNK_HEIGHT - 1.5f, coord(rng) * 0.5f);
+        d = glm::vec3(std::cos(a), -0.05f, std::sin(a));
+    }
+    const double rayNs = measureNs(20, [&] {
+        OctreeHit hit;
+        for (const auto& [o, d] : rays) sink += octree.raycast(o, d, 256.0f, hit);
+    }) / rays.size();
+    printResult("raycast, 256 blocks (octree)", rayNs);
+    std::printf("  %-44s %12.0f rays/s\n", "", 1e9 / rayNs);
+
+    doNotOptimize(sink);
+}
@@ -0,0 +1,167 @@
+#include "Benchmark.h"
+#include "Resources/Classes/World.h"
+#include "Resources/Classes/WorldGeneration.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    using Ray = std::pair<glm::vec3, glm::vec3>;
+
+    // One voxel per step through World::getBlockGlobal: what World::raycast skips past
+    bool voxelByVoxel(const World& world, const glm::vec3& origin, const glm::vec3& dir, float maxDist) {
+        const glm::vec3 d = glm::normalize(dir);
+        glm::ivec3 cell(glm::floor(origin));
+        glm::ivec3 step;
+        glm::vec3 tMax, tDelta;
+        for (int a = 0; a < 3; a++) {
+            step[a] = (d[a] > 0.0f) - (d[a] < 0.0f);
+            if (step[a] == 0) {
+                tMax[a] = tDelta[a] = 1e30f;
+                continue;
+            }
+            tMax[a] = (static_cast<float>(step[a] > 0 ? cell[a] + 1 : cell[a]) - origin[a]) / d[a];
+            tDelta[a] = std::abs(1.0f / d[a]);
+        }
+        for (float t = 0.0f; t <= maxDist;) {
+            if (world.getBlockGlobal(cell.x, cell.y, cell.z).isSolid()) return true;
+            const int a = tMax.x < tMax.y ? (tMax.x < tMax.z ? 0 : 2) : (tMax.y < tMax.z ? 1 : 2);
+            t = tMax[a];
+            tMax[a] += tDelta[a];
+            cell[a] += step[a];
+        }
+        return false;
+    }
+
+    void compare(const World& world, const std::vector<Ray>& rays, float maxDist, const char* name) {
+        int hits = 0;
+        const double fastNs = measureNs(20, [&] {
+            RaycastHit hit;
+            for (const auto& [o, d] : rays) hits += world.raycast(o, d, maxDist, hit);
+        }) / rays.size();
+        const double slowNs = measureNs(20, [&] {
+            for (const auto& [o, d] : rays) hits += voxelByVoxel(world, o, d, maxDist);
+        }) / rays.size();
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s (World::raycast)", name);
+        printResult(label, fastNs);
+        std::printf("  %-44s %12.0f rays/s\n", "", 1e9 / fastNs);
+        std::snprintf(label, sizeof(label), "%s (voxel by voxel)", name);
+        printResult(label, slowNs);
+        std::printf("  %-44s %12.0f rays/s\n", "", 1e9 / slowNs);
+        printSpeedup("speedup", slowNs, fastNs);
+        doNotOptimize(hits);
+    }
+
+    // Update until the workers are idle, so they do not compete with the rays being timed
+    void settle(World& world, const glm::vec3& center) {
+        for (;;) {
+            world.update(center);
+            const StreamingStats stats = world.getStreamingStats();
+            if (stats.generating == 0 && stats.meshing == 0 && stats.uploadsWaiting == 0) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // A server tick's line-of-sight checks: agents standing on the terrain, each looking
+    // at a handful of others nearby
+    std::vector<RayQuery> lineOfSightQueries(const World& world, const glm::vec3& center) {
+        constexpr int AGENTS = 2048;
+        constexpr int TARGETS = 16;
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> spread(-96.0f, 96.0f);
+        std::vector<glm::vec3> agents(AGENTS);
+        for (glm::vec3& agent : agents) {
+            const float x = center.x + spread(rng);
+            const float z = center.z + spread(rng);
+            const int ground = world.getSurfaceHeight(static_cast<int>(std::floor(x)), static_cast<int>(std::floor(z)));
+            agent = glm::vec3(x, static_cast<float>(ground) + 1.6f, z);
+        }
+
+        std::uniform_real_distribution<float> near(-32.0f, 32.0f);
+        std::vector<RayQuery> queries;
+        queries.reserve(AGENTS * TARGETS);
+        for (const glm::vec3& agent : agents) {
+            for (int i = 0; i < TARGETS; i++) {
+                const float x = agent.x + near(rng);
+                const float z = agent.z + near(rng);
+                const int ground = world.getSurfaceHeight(static_cast<int>(std::floor(x)), static_cast<int>(std::floor(z)));
+                const glm::vec3 target(x, static_cast<float>(ground) + 1.6f, z);
+                queries.push_back({agent, target - agent, glm::length(target - agent)});
+            }
+        }
+        return queries;
+    }
+
+    double lineOfSight(World& world, const glm::vec3& center, const char* name) {
+        const std::vector<RayQuery> queries = lineOfSightQueries(world, center);
+        std::vector<RaycastHit> hits(queries.size());
+        size_t blocked = 0;
+        const double ns = measureNs(10, [&] { blocked += world.raycastBatch(queries, hits); }) / queries.size();
+        printResult(name, ns);
+        std::printf("  %-44s %12.0f rays/s\n", "", 1e9 / ns);
+        doNotOptimize(blocked);
+        return ns;
+    }
+}
+
+void runRaycastBenchmarks() {
+    std::printf("World raycast\n");
+
+    WorldGeneration::initialize(1337);
+    World world(ThreadPool::defaultThreadCount());
+    const glm::vec3 center(8.0f, 10.0f, 8.0f);
+    settle(world, center);
+    // Rays stay well inside the loaded area, so every one crosses resident chunks
+    const float maxDist = static_cast<float>(world.getRenderDistance() * CHUNK_SIZE);
+
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    std::uniform_real_distribution<float> offset(-8.0f, 8.0f);
+
+    // Long, shallow rays over open terrain; most reach maxDist without a hit
+    std::vector<Ray> skimming(1024);
+    for (auto& [o, d] : skimming) {
+        const float a = angle(rng);
+        o = glm::vec3(center.x + offset(rng), CHUNK_HEIGHT - 1.5f, center.z + offset(rng));
+        d = glm::vec3(std::cos(a), -0.02f, std::sin(a));
+    }
+    compare(world, skimming, maxDist, "skimming rays, 128 blocks");
+
+    // From above the world down onto the ground, far from the origin
+    std::vector<Ray> descending(1024);
+    for (auto& [o, d] : descending) {
+        const float a = angle(rng);
+        o = glm::vec3(center.x + offset(rng), CHUNK_HEIGHT + 4.0f, center.z + offset(rng));
+        d = glm::vec3(std::cos(a), -0.12f, std::sin(a));
+    }
+    compare(world, descending, maxDist, "descending rays, 128 blocks");
+
+    // The same queries one at a time, then as packets on the calling thread alone and
+    // shared with every worker
+    std::printf("  %-44s %12u\n", "hardware threads", std::max(1u, std::thread::hardware_concurrency()));
+    const std::vector<RayQuery> queries = lineOfSightQueries(world, center);
+    size_t blocked = 0;
+    const double loopNs = measureNs(10, [&] {
+        RaycastHit hit;
+        for (const RayQuery& q : queries) blocked += world.raycast(q.origin, q.dir, q.maxDist, hit);
+    }) / queries.size();
+    printResult("line of sight x32768 (raycast loop)", loopNs);
+    std::printf("  %-44s %12.0f rays/s\n", "", 1e9 / loopNs);
+    doNotOptimize(blocked);
+
+    World serial(0);
+    settle(serial, center);
+    const double serialNs = lineOfSight(serial, center, "line of sight x32768 (batch, 1 thread)");
+    printSpeedup("speedup", loopNs, serialNs);
+    char label[64];
+    std::snprintf(label, sizeof(label), "line of sight x32768 (batch, 1 + %u workers)", ThreadPool::defaultThreadCount());
+    const double parallelNs = lineOfSight(world, center, label);
+    printSpeedup("speedup", loopNs, parallelNs);
+}
@@ -0,0 +1,324 @@
+#include "Benchmark.h"
+#include "Resources/Classes/Camera.h"
+#include "Resources/Classes/FrameStats.h"
+#include "Resources/Classes/World.h"
+#include "Resources/Classes/WorldGeneration.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr int FRAMES = 300;
+
+    bool pipelineIdle(const World& world) {
+        const StreamingStats stats = world.getStreamingStats();
+        return stats.generating == 0 && stats.meshing == 0 && stats.uploadsWaiting == 0;
+    }
+
+    // Time World::update while walking in a straight line, crossing a chunk border
+    // every 32 frames. The sleep stands in for rendering, which is when workers catch up.
+    void walk(unsigned threads, const char* name) {
+        World world(threads);
+        glm::vec3 position(8.0f, 10.0f, 8.0f);
+        do {
+            world.update(position);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } while (!pipelineIdle(world));
+
+        FrameStats frames(FRAMES);
+        for (int i = 0; i < FRAMES; i++) {
+            position.x += 0.5f;
+            const auto start = std::chrono::steady_clock::now();
+            world.update(position);
+            frames.addFrame(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            std::this_thread::sleep_for(std::chrono::milliseconds(4));
+        }
+        std::printf("  %-44s p50 %6.2f ms  p99 %6.2f ms  max %6.2f ms\n", name,
+                    frames.percentile(0.5), frames.percentile(0.99), frames.max());
+    }
+
+    // Camera looking along yaw (degrees, 0 is +x) from position, with the app's projection
+    Frustum viewFrom(const glm::vec3& position, float yaw) {
+        Camera camera(position);
+        camera.Yaw = yaw;
+        camera.ProcessMouseMovement(0.0f, 0.0f);
+        Frustum frustum;
+        frustum.update(glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 500.0f) * camera.GetViewMatrix());
+        return frustum;
+    }
+
+    // Chunks within the render distance (a circle) the camera can see that have no mesh yet
+    int missingInView(const World& world, const glm::vec3& position, const Frustum& view) {
+        const int cx = static_cast<int>(std::floor(position.x / CHUNK_SIZE));
+        const int cz = static_cast<int>(std::floor(position.z / CHUNK_SIZE));
+        const int r = world.getRenderDistance();
+        int missing = 0;
+        for (int x = cx - r; x <= cx + r; x++) {
+            for (int z = cz - r; z <= cz + r; z++) {
+                if ((x - cx) * (x - cx) + (z - cz) * (z - cz) > r * r + r) continue;
+                const glm::vec3 min(x * CHUNK_SIZE, 0.0f, z * CHUNK_SIZE);
+                const glm::vec3 max = min + glm::vec3(CHUNK_SIZE, CHUNK_HEIGHT, CHUNK_SIZE);
+                if (!view.isBoxVisible(min, max)) continue;
+                const Chunk* chunk = world.getChunk(x, z);
+                if (!chunk || !chunk->hasMesh()) missing++;
+            }
+        }
+        return missing;
+    }
+
+    // Frames until the chunk underfoot and then everything in view is drawn after a cold
+    // start, and how much of the view is missing on average while running at 2 blocks/frame
+    // and looking around
+    void loadOrder(bool useFrustum, const char* name) {
+        World world(ThreadPool::defaultThreadCount());
+        glm::vec3 position(8.0f, 10.0f, 8.0f);
+        int underfoot = -1;
+        int inView = -1;
+        for (int frame = 0; inView < 0; frame++) {
+            const Frustum view = viewFrom(position, 0.0f);
+            if (useFrustum) world.update(position, view); else world.update(position);
+            const Chunk* chunk = world.getChunk(0, 0);
+            if (underfoot < 0 && chunk && chunk->hasMesh()) underfoot = frame;
+            if (missingInView(world, position, view) == 0) inView = frame;
+            std::this_thread::sleep_for(std::chrono::milliseconds(4));
+        }
+        while (!pipelineIdle(world)) {
+            world.update(position);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        long missing = 0;
+        for (int i = 0; i < FRAMES; i++) {
+            position.x += 2.0f;
+            const Frustum view = viewFrom(position, 90.0f * std::sin(i * 0.05f));
+            if (useFrustum) world.update(position, view); else world.update(position);
+            missing += missingInView(world, position, view);
+            std::this_thread::sleep_for(std::chrono::milliseconds(4));
+        }
+        std::printf("  %-44s underfoot %3d  view %3d frames  running %5.1f missing\n", name,
+                    underfoot, inView, static_cast<double>(missing) / FRAMES);
+    }
+    // Cost of update() on frames where the player stays inside one chunk
+    void standingStill() {
+        World world(0);
+        glm::vec3 position(8.0f, 10.0f, 8.0f);
+        world.update(position);
+        const double still = measureNs(10000, [&] {
+            position.x = (position.x == 8.0f) ? 9.0f : 8.0f;
+            world.update(position);
+        });
+        printResult("update(), same chunk", still);
+    }
+
+    // Mesher jobs per chunk loaded, for a cold start and then a walk
+    void meshesPerLoad(unsigned threads, const char* name) {
+        World world(threads);
+        glm::vec3 position(8.0f, 10.0f, 8.0f);
+        do {
+            world.update(position);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } while (!pipelineIdle(world));
+        const StreamingStats start = world.getStreamingStats();
+
+        for (int i = 0; i < FRAMES; i++) {
+            position.x += 1.0f;
+            world.update(position);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        do {
+            world.update(position);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } while (!pipelineIdle(world));
+        const StreamingStats end = world.getStreamingStats();
+
+        std::printf("  %-44s start %5.2f  walk %5.2f meshes per load\n", name,
+                    static_cast<double>(start.meshesBuilt) / start.loadedChunks,
+                    static_cast<double>(end.meshesBuilt - start.meshesBuilt) / (end.loadedChunks - start.loadedChunks));
+    }
+
+    // Walk back and forth across a chunk border and count what gets unloaded and reloaded
+    void pacing(int crossings) {
+        World world(0);
+        glm::vec3 position(120.0f, 10.0f, 8.0f);
+        world.update(position);
+        const StreamingStats before = world.getStreamingStats();
+        for (int i = 0; i < crossings; i++) {
+            position.x = (i % 2 == 0) ? 136.0f : 120.0f;
+            world.update(position);
+        }
+        const StreamingStats after = world.getStreamingStats();
+        std::printf("  load radius %d, unload radius %d, %d crossings\n", world.getLoadDistance(),
+                    world.getUnloadDistance(), crossings);
+        std::printf("  %-44s loads %4llu  unloads %4llu  reloads %4llu\n", "pacing across a border",
+                    static_cast<unsigned long long>(after.loadedChunks - before.loadedChunks),
+                    static_cast<unsigned long long>(after.unloadedChunks - before.unloadedChunks),
+                    static_cast<unsigned long long>(after.reloadedChunks - before.reloadedChunks));
+    }
+
+    // Server mode: observers walking around a shared 64 x 64 chunk area, each keeping a
+    // radius of 6 loaded. The more of them, the more their regions overlap.
+    void sharedObservers(int count) {
+        constexpr int RADIUS = 6;
+        constexpr float AREA = 64.0f * CHUNK_SIZE;
+        constexpr int MOVES = 200;
+
+        World world(ThreadPool::defaultThreadCount());
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> coordinate(0.0f, AREA);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+        std::vector<glm::vec3> positions(count);
+        std::vector<glm::vec3> headings(count);
+        std::vector<World::ObserverId> ids(count);
+        for (int i = 0; i < count; i++) {
+            positions[i] = glm::vec3(coordinate(rng), 10.0f, coordinate(rng));
+            const float a = angle(rng);
+            headings[i] = glm::vec3(std::cos(a), 0.0f, std::sin(a));
+            ids[i] = world.addObserver(positions[i], RADIUS);
+        }
+        do {
+            world.update();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } while (!pipelineIdle(world));
+        const StreamingStats settled = world.getStreamingStats();
+
+        // One block per update, turning back at the edges of the area
+        FrameStats frames(MOVES);
+        for (int frame = 0; frame < MOVES; frame++) {
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < count; i++) {
+                positions[i] += headings[i];
+                if (positions[i].x < 0.0f || positions[i].x > AREA) headings[i].x = -headings[i].x;
+                if (positions[i].z < 0.0f || positions[i].z > AREA) headings[i].z = -headings[i].z;
+                world.moveObserver(ids[i], positions[i]);
+            }
+            world.update();
+            frames.addFrame(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            std::this_thread::sleep_for(std::chrono::milliseconds(4));
+        }
+        while (!pipelineIdle(world)) {
+            world.update();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const StreamingStats moved = world.getStreamingStats();
+
+        const double windows = static_cast<double>(count) * (2 * RADIUS + 1) * (2 * RADIUS + 1);
+        char name[64];
+        std::snprintf(name, sizeof(name), "%d observers", count);
+        std::printf("  %-44s resident %5zu (%4.0f%% of windows)  update p50 %5.2f ms p99 %5.2f ms  loads %5llu\n",
+                    name, settled.residentChunks, 100.0 * settled.residentChunks / windows, frames.percentile(0.5),
+                    frames.percentile(0.99), static_cast<unsigned long long>(moved.loadedChunks - settled.loadedChunks));
+    }
+
+    // Chunks resident around a server observer of each radius once everything is loaded
+    void shapeAtRadius(int radius) {
+        size_t resident[2];
+        for (ResidencyShape shape : {ResidencyShape::Square, ResidencyShape::Circle}) {
+            World world(ThreadPool::defaultThreadCount());
+            world.setResidencyShape(shape);
+            world.addObserver(glm::vec3(8.0f, 10.0f, 8.0f), radius);
+            do {
+                world.update();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            } while (!pipelineIdle(world));
+            resident[shape == ResidencyShape::Circle] = world.getStreamingStats().residentChunks;
+        }
+        char name[64];
+        std::snprintf(name, sizeof(name), "radius %d", radius);
+        std::printf("  %-44s square %5zu  circle %5zu  saved %5zu (%2.0f%%)\n", name, resident[0], resident[1],
+                    resident[0] - resident[1], 100.0 * (resident[0] - resident[1]) / resident[0]);
+    }
+
+    // The player's resident chunks, and whether anything within the render distance that
+    // the camera sees is missing, standing still and then after turning half a circle
+    void playerShape(ResidencyShape shape, float stretch, const char* name) {
+        World world(ThreadPool::defaultThreadCount());
+        world.setResidencyShape(shape, stretch);
+        const glm::vec3 position(8.0f, 10.0f, 8.0f);
+        const Frustum ahead = viewFrom(position, 0.0f);
+        do {
+            world.update(position, ahead);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } while (!pipelineIdle(world));
+        const size_t resident = world.getStreamingStats().residentChunks;
+        const int missing = missingInView(world, position, ahead);
+
+        // Frames until what is now in view is drawn
+        const Frustum behind = viewFrom(position, 180.0f);
+        int turned = 0;
+        for (; missingInView(world, position, behind) > 0; turned++) {
+            world.update(position, behind);
+            std::this_thread::sleep_for(std::chrono::milliseconds(4));
+        }
+        std::printf("  %-44s resident %4zu  missing in view %d  after turning around %2d frames\n", name, resident,
+                    missing, turned);
+    }
+
+    // Walk 300 blocks out and back from a cold start under the given budgets (0 for none).
+    // Returns the peak usage; drawn is the average number of chunks with a mesh to draw.
+    MemoryStats memoryBudget(size_t voxelBudget, size_t meshBudget, const char* name) {
+        World world(ThreadPool::defaultThreadCount());
+        world.setMemoryBudget(voxelBudget, meshBudget);
+        glm::vec3 position(8.0f, 10.0f, 8.0f);
+        MemoryStats peak;
+        double drawn = 0.0;
+        for (int frame = 0; frame < 3 * FRAMES; frame++) {
+            // A third standing still to fill the window, then out and back
+            if (frame >= FRAMES) position.x += frame < 2 * FRAMES ? 1.0f : -1.0f;
+            world.update(position);
+            const MemoryStats memory = world.getMemoryStats();
+            peak.voxelBytes = std::max(peak.voxelBytes, memory.voxelBytes);
+            peak.meshBytes = std::max(peak.meshBytes, memory.meshBytes);
+            world.forEachDrawableChunk([&](const Chunk&) { drawn += 1.0; });
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        const StreamingStats streaming = world.getStreamingStats();
+        const MemoryStats memory = world.getMemoryStats();
+
+        constexpr double MB = 1024.0 * 1024.0;
+        std::printf("  %-30s voxels %5.1f MB  meshes %5.1f MB  drawn %5.0f  loads %5llu  evicted %5llu chunks %5llu meshes\n",
+                    name, peak.voxelBytes / MB, peak.meshBytes / MB, drawn / (3 * FRAMES),
+                    static_cast<unsigned long long>(streaming.loadedChunks),
+                    static_cast<unsigned long long>(memory.evictedChunks),
+                    static_cast<unsigned long long>(memory.evictedMeshes));
+        return peak;
+    }
+}
+
+void runStreamingBenchmarks() {
+    std::printf("Chunk streaming, update() time per frame\n");
+
+    WorldGeneration::initialize(1337);
+    walk(0, "inline (no worker threads)");
+    walk(ThreadPool::defaultThreadCount(), "worker threads");
+
+    std::printf("Chunk load order, frames until drawn (4 ms per frame)\n");
+    loadOrder(false, "nearest first");
+    loadOrder(true, "nearest first, view frustum ahead");
+
+    std::printf("Chunk residency\n");
+    pacing(100);
+    standingStill();
+
+    std::printf("Meshes per chunk loaded\n");
+    meshesPerLoad(0, "inline (no worker threads)");
+    meshesPerLoad(ThreadPool::defaultThreadCount(), "worker threads");
+
+    std::printf("Shared residency (server), radius 6, 200 updates walking 1 block each\n");
+    for (int count : {1, 10, 100, 300, 600}) sharedObservers(count);
+
+    std::printf("Residency shape, chunks resident around one observer\n");
+    for (int radius : {8, 12, 16, 24}) shapeAtRadius(radius);
+    playerShape(ResidencyShape::Square, 0.0f, "player, square");
+    playerShape(ResidencyShape::Circle, 0.0f, "player, circle");
+    playerShape(ResidencyShape::Circle, 0.5f, "player, circle stretched 0.5 along the view");
+    playerShape(ResidencyShape::Circle, 0.75f, "player, circle stretched 0.75 along the view");
+
+    std::printf("Memory budgets, peak usage over a walk out and back\n");
+    const MemoryStats unlimited = memoryBudget(0, 0, "no budget");
+    memoryBudget(unlimited.voxelBytes / 2, 0, "voxels at half that");
+    memoryBudget(0, unlimited.meshBytes / 2, "meshes at half that");
+    memoryBudget(unlimited.voxelBytes * 2, unlimited.meshBytes, "voxels at twice that (cache)");
+}
@@ -0,0 +1,15 @@
+#include "Benchmark.h"
+
+// Links voxel_core alone: no window or GL context is needed
+int main() {
+    runChunkBenchmarks();
+    runColdCacheBenchmarks();
+    runOctreeBenchmarks();
+    runLightBenchmarks();
+    runStreamingBenchmarks();
+    runEditJournalBenchmarks();
+    runRaycastBenchmarks();
+    runBoxReadBenchmarks();
+    runConcurrentMapBenchmarks();
+    return 0;
+}
@@ -1,14 +1,24 @@
 //
-// Simplified Block implementation matching Chunk usage
+// Runtime registration for block types beyond the built-in set
 //
 #include "Block.h"
+#include <stdexcept>
+#include <string>
 
-glm::vec3 Block::getColor() const {
-    switch (type) {
-        case BlockType::DIRT:  return glm::vec3(0.545f, 0.271f, 0.075f);
-        case BlockType::GRASS: return glm::vec3(0.200f, 0.800f, 0.200f);
-        case BlockType::STONE: return glm::vec3(0.600f, 0.600f, 0.600f);
-        case BlockType::AIR:   return glm::vec3(0.0f, 1.0f, 1.0f); // Bright cyan for debugging
-        default:               return glm::vec3(1.0f, 0.0f, 1.0f); // Magenta for unknown
+BlockType BlockRegistry::registerBlock(const BlockDefinition& definition) {
+    if (sealed) {
+        throw std::runtime_error("Cannot register '" + std::string(definition.name) + "' after a World was created");
     }
+    if (blockCount >= MAX_BLOCK_TYPES) {
+        throw std::runtime_error("Block registry is full, cannot register '" + std::string(definition.name) + "'");
+    }
+
+    const int newId = blockCount++;
+    solid[newId] = definition.solid;
+    opaque[newId] = definition.opaque;
+    colors[newId] = definition.color;
+    textureLayers[newId] = definition.textureLayer;
+    lightEmissions[newId] = definition.lightEmission;
+    names[newId] = definition.name;
+    return static_cast<BlockType>(newId);
 }
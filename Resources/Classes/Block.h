@@ -1,24 +1,105 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
 
-// Keep AIR = 0 so memset in Chunk initializes to AIR
-enum class BlockType : int {
+// Keep AIR = 0: new chunk sections are value-initialized, which makes every block AIR.
+// IDs past the built-in set are handed out by BlockRegistry::registerBlock.
+enum class BlockType : uint8_t {
     AIR = 0,
     DIRT,
     GRASS,
     STONE
 };
 
+constexpr int MAX_BLOCK_TYPES = 256;
+
+struct BlockColor {
+    float r, g, b;
+};
+
+struct BlockDefinition {
+    const char* name;
+    bool solid;            // Has geometry and blocks movement
+    bool opaque;           // Hides the faces of neighbors touching it
+    BlockColor color;
+    uint8_t textureLayer;
+    uint8_t lightEmission; // 0-15
+};
+
+// Built-in blocks, indexed by BlockType
+constexpr BlockDefinition BUILTIN_BLOCKS[] = {
+    {"air",   false, false, {0.000f, 1.000f, 1.000f}, 0, 0}, // Bright cyan for debugging
+    {"dirt",  true,  true,  {0.545f, 0.271f, 0.075f}, 1, 0},
+    {"grass", true,  true,  {0.200f, 0.800f, 0.200f}, 2, 0},
+    {"stone", true,  true,  {0.600f, 0.600f, 0.600f}, 3, 0},
+};
+
+// Per-ID block properties stored as one contiguous table per property, so hot loops
+// (meshing, culling, lighting) touch a single small array indexed by ID.
+// The built-in set is filled in at compile time; registerBlock appends at startup.
+class BlockRegistry {
+public:
+    // Returns the new block's ID; throws std::runtime_error when all IDs are taken.
+    // The tables are read without locking by mesher and light jobs, so every block must
+    // be registered before the first World is constructed; registering later throws too.
+    static BlockType registerBlock(const BlockDefinition& definition);
+    // Called by World's constructor: from here on the tables are read-only
+    static void seal() { sealed = true; }
+    static int count() { return blockCount; }
+
+    static bool isSolid(BlockType type) { return solid[id(type)]; }
+    static bool isOpaque(BlockType type) { return opaque[id(type)]; }
+    static const BlockColor& color(BlockType type) { return colors[id(type)]; }
+    static uint8_t textureLayer(BlockType type) { return textureLayers[id(type)]; }
+    static uint8_t lightEmission(BlockType type) { return lightEmissions[id(type)]; }
+    static const char* name(BlockType type) { return names[id(type)]; }
+
+private:
+    static constexpr int id(BlockType type) { return static_cast<uint8_t>(type); }
+
+    template <typename T, typename Field>
+    static constexpr std::array<T, MAX_BLOCK_TYPES> builtinTable(T fallback, Field field) {
+        std::array<T, MAX_BLOCK_TYPES> table{};
+        table.fill(fallback);
+        for (size_t i = 0; i < std::size(BUILTIN_BLOCKS); i++) {
+            table[i] = field(BUILTIN_BLOCKS[i]);
+        }
+        return table;
+    }
+
+    static inline std::atomic<bool> sealed{false};
+    // Unregistered IDs behave like air but render magenta
+    static inline int blockCount = static_cast<int>(std::size(BUILTIN_BLOCKS));
+    static inline std::array<bool, MAX_BLOCK_TYPES> solid =
+        builtinTable<bool>(false, [](const BlockDefinition& d) { return d.solid; });
+    static inline std::array<bool, MAX_BLOCK_TYPES> opaque =
+        builtinTable<bool>(false, [](const BlockDefinition& d) { return d.opaque; });
+    static inline std::array<BlockColor, MAX_BLOCK_TYPES> colors =
+        builtinTable<BlockColor>({1.0f, 0.0f, 1.0f}, [](const BlockDefinition& d) { return d.color; });
+    static inline std::array<uint8_t, MAX_BLOCK_TYPES> textureLayers =
+        builtinTable<uint8_t>(0, [](const BlockDefinition& d) { return d.textureLayer; });
+    static inline std::array<uint8_t, MAX_BLOCK_TYPES> lightEmissions =
+        builtinTable<uint8_t>(0, [](const BlockDefinition& d) { return d.lightEmission; });
+    static inline std::array<const char*, MAX_BLOCK_TYPES> names =
+        builtinTable<const char*>("unknown", [](const BlockDefinition& d) { return d.name; });
+};
+
 struct Block {
     BlockType type;
 
-    // Solid if it's not AIR
     bool isSolid() const {
-        return type != BlockType::AIR;
+        return BlockRegistry::isSolid(type);
     }
 
-    // Basic color per block type
-    glm::vec3 getColor() const;
-};
+    bool isOpaque() const {
+        return BlockRegistry::isOpaque(type);
+    }
 
+    glm::vec3 getColor() const {
+        const BlockColor& c = BlockRegistry::color(type);
+        return glm::vec3(c.r, c.g, c.b);
+    }
+};
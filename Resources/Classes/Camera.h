@@ -10,6 +10,8 @@ class Frustum {
 public:
     void update(const glm::mat4& viewProjMatrix);
     bool isBoxVisible(const glm::vec3& min, const glm::vec3& max) const;
+    // Unit vector the camera looks along: the near plane's normal
+    glm::vec3 forward() const { return glm::vec3(planes[4]); }
     
 private:
     glm::vec4 planes[6];
@@ -1,173 +1,285 @@
 #include "Chunk.h"
+#include "ChunkMesher.h"
 #include "World.h"
-#include <Lib/Glad/include/glad/glad.h>
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 
+namespace {
+    // Shared by all chunks so revisions are never reused; tools may mesh on any thread
+    std::atomic<uint64_t> nextMeshRevision{0};
+}
+
+Block ChunkSnapshot::getBlock(int x, int y, int z) const {
+    if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_HEIGHT || z < 0 || z >= CHUNK_SIZE)
+        return Block{BlockType::AIR};
+    return sections[y / SECTION_HEIGHT]->blocks[Chunk::blockIndex(x, y % SECTION_HEIGHT, z)];
+}
+
+uint8_t ChunkSnapshot::getLight(int x, int y, int z) const {
+    if (y >= CHUNK_HEIGHT) return FULL_SKY_LIGHT;
+    if (x < 0 || x >= CHUNK_SIZE || y < 0 || z < 0 || z >= CHUNK_SIZE) return 0;
+    return sections[y / SECTION_HEIGHT]->light[Chunk::blockIndex(x, y % SECTION_HEIGHT, z)];
+}
+
 Chunk::Chunk(glm::ivec2 position) : position(position) {
-    // Initialize all blocks to air
-    memset(blocks, 0, sizeof(blocks));
+    // Initialize all blocks to air (make_shared value-initializes, and AIR is 0)
+    for (auto& section : sections) {
+        section = std::make_shared<ChunkSection>();
+    }
+}
+
+
+ChunkSection& Chunk::writableSection(int sectionIndex) {
+    contentRevision++;
+    std::shared_ptr<ChunkSection>& section = sections[sectionIndex];
+    if (section.use_count() != 1) {
+        // A snapshot still references this data; give the chunk its own copy
+        section = std::make_shared<ChunkSection>(*section);
+    }
+    return *section;
+}
+
+ChunkSnapshot Chunk::snapshot() const {
+    ChunkSnapshot snap;
+    snap.position = position;
+    for (int i = 0; i < CHUNK_SECTIONS; i++) {
+        snap.sections[i] = sections[i];
+    }
+    snap.heightMap = heightMap;
+    snap.minSolidY = minSolidY;
+    snap.maxSolidY = maxSolidY;
+    snap.occupancy = occupancy;
+    return snap;
+}
+
+void Chunk::updateColumn(int x, int z) {
+    int y = CHUNK_HEIGHT - 1;
+    while (y >= 0 && !sections[y / SECTION_HEIGHT]->blocks[blockIndex(x, y % SECTION_HEIGHT, z)].isSolid()) y--;
+    heightMap[z * CHUNK_SIZE + x] = static_cast<uint8_t>(y + 1);
+}
+
+void Chunk::updateColumnAfterFill(int x, int z, int yBegin, int yEnd, Block block) {
+    uint8_t& height = heightMap[z * CHUNK_SIZE + x];
+    if (block.isSolid()) {
+        height = std::max<uint8_t>(height, static_cast<uint8_t>(yEnd));
+    } else if (yBegin < height && yEnd >= height) {
+        // Cleared the top of the column; only then does the surface need a rescan
+        updateColumn(x, z);
+    }
+}
+
+void Chunk::updateHeightMap() {
+    // Walk whole layers from the top so reads stay contiguous; a layer's index
+    // z * CHUNK_SIZE + x is also the height map index
+    heightMap.fill(0);
+    int remaining = CHUNK_AREA;
+    int top = 0;
+    for (int y = CHUNK_HEIGHT - 1; y >= 0 && remaining > 0; y--) {
+        const Block* layer = sections[y / SECTION_HEIGHT]->blocks + blockIndex(0, y % SECTION_HEIGHT, 0);
+        for (int i = 0; i < CHUNK_AREA; i++) {
+            if (heightMap[i] == 0 && layer[i].isSolid()) {
+                heightMap[i] = static_cast<uint8_t>(y + 1);
+                remaining--;
+                top = std::max(top, y + 1);
+            }
+        }
+    }
+    maxSolidY = top - 1;
+    updateOccupancy();
 
-    // Generate OpenGL buffers
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
+    // Lowest layer holding anything solid; bedrock usually ends this at y = 0
+    minSolidY = CHUNK_HEIGHT;
+    for (int y = 0; y < top && minSolidY == CHUNK_HEIGHT; y++) {
+        const Block* layer = sections[y / SECTION_HEIGHT]->blocks + blockIndex(0, y % SECTION_HEIGHT, 0);
+        for (int i = 0; i < CHUNK_AREA; i++) {
+            if (layer[i].isSolid()) {
+                minSolidY = y;
+                break;
+            }
+        }
+    }
+}
+
+void Chunk::updateOccupancy() {
+    for (int i = 0; i < CHUNK_SECTIONS; i++) {
+        const Block* blocks = sections[i]->blocks;
+        uint64_t bits = 0;
+        for (int y = 0; y < SECTION_HEIGHT; y++) {
+            for (int z = 0; z < CHUNK_SIZE; z++) {
+                const Block* row = blocks + blockIndex(0, y, z);
+                for (int x = 0; x < CHUNK_SIZE; x++) {
+                    if (row[x].isSolid()) bits |= uint64_t(1) << brickBit(x, y, z);
+                }
+            }
+        }
+        occupancy[i] = bits;
+    }
+}
+
+bool Chunk::brickHasSolid(int x, int y, int z) const {
+    const Block* blocks = sections[y / SECTION_HEIGHT]->blocks;
+    const int sy = y % SECTION_HEIGHT / BRICK_SIZE * BRICK_SIZE;
+    const int bz = z / BRICK_SIZE * BRICK_SIZE;
+    const int bx = x / BRICK_SIZE * BRICK_SIZE;
+    for (int ly = sy; ly < sy + BRICK_SIZE; ly++) {
+        for (int lz = bz; lz < bz + BRICK_SIZE; lz++) {
+            const Block* row = blocks + blockIndex(bx, ly, lz);
+            for (int lx = 0; lx < BRICK_SIZE; lx++) {
+                if (row[lx].isSolid()) return true;
+            }
+        }
+    }
+    return false;
 }
 
 Block Chunk::getBlock(int x, int y, int z) const {
     if (x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_HEIGHT || z < 0 || z >= CHUNK_SIZE)
         return Block{BlockType::AIR};
-    return blocks[x][y][z];
+    return sections[y / SECTION_HEIGHT]->blocks[blockIndex(x, y % SECTION_HEIGHT, z)];
 }
 
 void Chunk::setBlock(int x, int y, int z, Block block) {
     if (x >= 0 && x < CHUNK_SIZE && y >= 0 && y < CHUNK_HEIGHT && z >= 0 && z < CHUNK_SIZE) {
-        blocks[x][y][z] = block;
-        needsMeshUpdate = true;
+        writableSection(y / SECTION_HEIGHT).blocks[blockIndex(x, y % SECTION_HEIGHT, z)] = block;
+
+        uint8_t& height = heightMap[z * CHUNK_SIZE + x];
+        if (block.isSolid()) {
+            height = std::max<uint8_t>(height, static_cast<uint8_t>(y + 1));
+            minSolidY = std::min(minSolidY, y);
+            maxSolidY = std::max(maxSolidY, y);
+        } else if (y + 1 == height) {
+            // Removed the top of the column: walk down to the next solid block
+            updateColumn(x, z);
+        }
+        updateBrickAfterFill(x, y, z, block);
     }
 }
 
-void Chunk::generateMeshWithWorld(const World& world) {
-    meshVertices.clear();
-
-    const int baseX = position.x * CHUNK_SIZE;
-    const int baseZ = position.y * CHUNK_SIZE;
-
-    auto isSolidGlobal = [&](int gx, int gy, int gz) -> bool {
-        if (gy < 0 || gy >= CHUNK_HEIGHT) return false; // outside vertical bounds => air
-        return world.getBlockGlobal(gx, gy, gz).isSolid();
-    };
-
-    for (int y = 0; y < CHUNK_HEIGHT; y++) {
-        for (int z = 0; z < CHUNK_SIZE; z++) {
-            for (int x = 0; x < CHUNK_SIZE; x++) {
-                Block current = getBlock(x, y, z);
-                if (!current.isSolid()) continue;
-
-                const int gx = baseX + x;
-                const int gz = baseZ + z;
-
-                if (!isSolidGlobal(gx-1, y, gz))
-                    addFace({x, y, z}, {-1, 0, 0}, current.type);
-                if (!isSolidGlobal(gx+1, y, gz))
-                    addFace({x, y, z}, {1, 0, 0}, current.type);
-                if (!isSolidGlobal(gx, y-1, gz))
-                    addFace({x, y, z}, {0, -1, 0}, current.type);
-                if (!isSolidGlobal(gx, y+1, gz))
-                    addFace({x, y, z}, {0, 1, 0}, current.type);
-                if (!isSolidGlobal(gx, y, gz-1))
-                    addFace({x, y, z}, {0, 0, -1}, current.type);
-                if (!isSolidGlobal(gx, y, gz+1))
-                    addFace({x, y, z}, {0, 0, 1}, current.type);
+uint8_t Chunk::getLight(int x, int y, int z) const {
+    if (y >= CHUNK_HEIGHT) return FULL_SKY_LIGHT;
+    if (x < 0 || x >= CHUNK_SIZE || y < 0 || z < 0 || z >= CHUNK_SIZE) return 0;
+    return sections[y / SECTION_HEIGHT]->light[blockIndex(x, y % SECTION_HEIGHT, z)];
+}
+
+void Chunk::setLight(int x, int y, int z, uint8_t light) {
+    if (x >= 0 && x < CHUNK_SIZE && y >= 0 && y < CHUNK_HEIGHT && z >= 0 && z < CHUNK_SIZE) {
+        writableSection(y / SECTION_HEIGHT).light[blockIndex(x, y % SECTION_HEIGHT, z)] = light;
+    }
+}
+
+void Chunk::setLightData(std::span<const uint8_t, CHUNK_VOLUME> light) {
+    for (int i = 0; i < CHUNK_SECTIONS; i++) {
+        memcpy(writableSection(i).light, light.data() + i * SECTION_VOLUME, sizeof(ChunkSection::light));
+    }
+}
+
+void Chunk::fillColumn(int x, int z, int yBegin, int yEnd, Block block) {
+    if (x < 0 || x >= CHUNK_SIZE || z < 0 || z >= CHUNK_SIZE) return;
+    yBegin = std::max(yBegin, 0);
+    yEnd = std::min(yEnd, CHUNK_HEIGHT);
+    if (yBegin >= yEnd) return;
+
+    for (int y = yBegin; y < yEnd;) {
+        const int sectionIndex = y / SECTION_HEIGHT;
+        const int sectionBase = sectionIndex * SECTION_HEIGHT;
+        const int sectionEnd = std::min(yEnd, sectionBase + SECTION_HEIGHT);
+        Block* blocks = writableSection(sectionIndex).blocks;
+        for (; y < sectionEnd; y++) {
+            blocks[blockIndex(x, y - sectionBase, z)] = block;
+        }
+    }
+
+    updateColumnAfterFill(x, z, yBegin, yEnd, block);
+    for (int y = yBegin / BRICK_SIZE * BRICK_SIZE; y < yEnd; y += BRICK_SIZE) {
+        updateBrickAfterFill(x, y, z, block);
+    }
+    if (block.isSolid()) {
+        minSolidY = std::min(minSolidY, yBegin);
+        maxSolidY = std::max(maxSolidY, yEnd - 1);
+    }
+}
+
+void Chunk::fillBox(const glm::ivec3& min, const glm::ivec3& max, Block block) {
+    const glm::ivec3 lo(std::max(min.x, 0), std::max(min.y, 0), std::max(min.z, 0));
+    const glm::ivec3 hi(std::min(max.x, CHUNK_SIZE), std::min(max.y, CHUNK_HEIGHT), std::min(max.z, CHUNK_SIZE));
+    if (lo.x >= hi.x || lo.y >= hi.y || lo.z >= hi.z) return;
+
+    // Each (y, z) row is contiguous in x
+    for (int y = lo.y; y < hi.y; y++) {
+        Block* blocks = writableSection(y / SECTION_HEIGHT).blocks;
+        for (int z = lo.z; z < hi.z; z++) {
+            Block* row = blocks + blockIndex(0, y % SECTION_HEIGHT, z);
+            std::fill(row + lo.x, row + hi.x, block);
+        }
+    }
+
+    for (int z = lo.z; z < hi.z; z++) {
+        for (int x = lo.x; x < hi.x; x++) {
+            updateColumnAfterFill(x, z, lo.y, hi.y, block);
+        }
+    }
+    for (int y = lo.y / BRICK_SIZE * BRICK_SIZE; y < hi.y; y += BRICK_SIZE) {
+        for (int z = lo.z / BRICK_SIZE * BRICK_SIZE; z < hi.z; z += BRICK_SIZE) {
+            for (int x = lo.x / BRICK_SIZE * BRICK_SIZE; x < hi.x; x += BRICK_SIZE) {
+                updateBrickAfterFill(x, y, z, block);
             }
         }
     }
-    
-    uploadMeshToGPU();
-}
-
-void Chunk::uploadMeshToGPU() {
-    // Upload mesh to GPU
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, meshVertices.size() * sizeof(float), meshVertices.data(), GL_STATIC_DRAW);
-    
-    // Vertex attributes (position + normal + color)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 9 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-    
-    vertexCount = meshVertices.size() / 9;
+    if (block.isSolid()) {
+        minSolidY = std::min(minSolidY, lo.y);
+        maxSolidY = std::max(maxSolidY, hi.y - 1);
+    }
+}
+
+void Chunk::copyFrom(std::span<const BlockType, CHUNK_VOLUME> ids) {
+    static_assert(sizeof(Block) == sizeof(BlockType), "Block must stay a plain BlockType wrapper");
+    contentRevision++;
+    for (int i = 0; i < CHUNK_SECTIONS; i++) {
+        // Every block is replaced, so a shared section only needs its light copied
+        if (sections[i].use_count() != 1) {
+            auto fresh = std::make_shared<ChunkSection>();
+            memcpy(fresh->light, sections[i]->light, sizeof(ChunkSection::light));
+            sections[i] = std::move(fresh);
+        }
+        memcpy(sections[i]->blocks, ids.data() + i * SECTION_VOLUME, sizeof(ChunkSection::blocks));
+    }
+    updateHeightMap();
+}
+
+std::array<std::optional<ChunkSnapshot>, 9> Chunk::neighborhood(const World& world) const {
+    std::array<std::optional<ChunkSnapshot>, 9> around;
+    for (int dz = -1; dz <= 1; dz++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            const Chunk* chunk = (dx == 0 && dz == 0) ? this : world.getChunk(position.x + dx, position.y + dz);
+            if (chunk) around[(dz + 1) * 3 + (dx + 1)] = chunk->snapshot();
+        }
+    }
+    return around;
+}
+
+void Chunk::generateMeshWithWorld(const World& world) {
     needsMeshUpdate = false;
+    auto padded = std::make_unique<PaddedChunk>();
+    // The snapshots are dropped as soon as the border is copied out
+    padded->gather(neighborhood(world));
+
+    std::vector<float> vertices;
+    ChunkMesher::buildMesh(*padded, vertices);
+    setMesh(std::move(vertices));
 }
 
-void Chunk::addFace(const glm::vec3& position, const glm::vec3& normal, BlockType type) {
-    glm::vec3 color = Block{type}.getColor();
-    
-    // Small offset to prevent z-fighting at chunk boundaries
-    const float epsilon = 0.001f;
-    const float offsetX = normal.x * epsilon;
-    const float offsetY = normal.y * epsilon;
-    const float offsetZ = normal.z * epsilon;
-
-    const float x = position.x + offsetX;
-    const float y = position.y + offsetY;
-    const float z = position.z + offsetZ;
-
-    auto pushVertex = [&](float px, float py, float pz) {
-        meshVertices.push_back(px);
-        meshVertices.push_back(py);
-        meshVertices.push_back(pz);
-        meshVertices.push_back(normal.x);
-        meshVertices.push_back(normal.y);
-        meshVertices.push_back(normal.z);
-        meshVertices.push_back(color.r);
-        meshVertices.push_back(color.g);
-        meshVertices.push_back(color.b);
-    };
-
-    // Build two triangles (A,B,C) and (A,C,D) with CCW winding facing the normal
-    if (normal.x == 1.0f) {
-        // Right face (x+1)
-        // A: (x+1,y,  z+1), B: (x+1,y+1,z+1), C: (x+1,y+1,z), D: (x+1,y,  z)
-        pushVertex(x+1, y,   z+1);
-        pushVertex(x+1, y+1, z+1);
-        pushVertex(x+1, y+1, z  );
-        pushVertex(x+1, y,   z+1);
-        pushVertex(x+1, y+1, z  );
-        pushVertex(x+1, y,   z  );
-    } else if (normal.x == -1.0f) {
-        // Left face (x)
-        // A: (x,y,  z), B: (x,y+1,z), C: (x,y+1,z+1), D: (x,y,  z+1)
-        pushVertex(x, y,   z  );
-        pushVertex(x, y+1, z  );
-        pushVertex(x, y+1, z+1);
-        pushVertex(x, y,   z  );
-        pushVertex(x, y+1, z+1);
-        pushVertex(x, y,   z+1);
-    } else if (normal.y == 1.0f) {
-        // Top face (y+1)
-        // A: (x,  y+1,z+1), B: (x+1,y+1,z+1), C: (x+1,y+1,z), D: (x,  y+1,z)
-        pushVertex(x,   y+1, z+1);
-        pushVertex(x+1, y+1, z+1);
-        pushVertex(x+1, y+1, z  );
-        pushVertex(x,   y+1, z+1);
-        pushVertex(x+1, y+1, z  );
-        pushVertex(x,   y+1, z  );
-    } else if (normal.y == -1.0f) {
-        // Bottom face (y)
-        // A: (x,  y,z), B: (x+1,y,z), C: (x+1,y,z+1), D: (x,  y,z+1)
-        pushVertex(x,   y, z  );
-        pushVertex(x+1, y, z  );
-        pushVertex(x+1, y, z+1);
-        pushVertex(x,   y, z  );
-        pushVertex(x+1, y, z+1);
-        pushVertex(x,   y, z+1);
-    } else if (normal.z == 1.0f) {
-        // Front face (z+1)
-        // A: (x,  y,  z+1), B: (x+1,y,  z+1), C: (x+1,y+1,z+1), D: (x,  y+1,z+1)
-        pushVertex(x,   y,   z+1);
-        pushVertex(x+1, y,   z+1);
-        pushVertex(x+1, y+1, z+1);
-        pushVertex(x,   y,   z+1);
-        pushVertex(x+1, y+1, z+1);
-        pushVertex(x,   y+1, z+1);
-    } else if (normal.z == -1.0f) {
-        // Back face (z)
-        // A: (x+1,y,  z), B: (x+1,y+1,z), C: (x,  y+1,z), D: (x,  y,  z)
-        pushVertex(x+1, y,   z);
-        pushVertex(x+1, y+1, z);
-        pushVertex(x,   y+1, z);
-        pushVertex(x+1, y,   z);
-        pushVertex(x,   y+1, z);
-        pushVertex(x,   y,   z);
-    }
-}
-
-void Chunk::render() const {
-    if (vertexCount == 0) return;
-    
-    glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
-}
\ No newline at end of file
+void Chunk::setMesh(std::vector<float>&& vertices) {
+    meshVertices = std::move(vertices);
+    meshRevision = ++nextMeshRevision;
+}
+
+void Chunk::clearMesh() {
+    std::vector<float>().swap(meshVertices);
+    meshRevision = 0;
+}
+
+size_t Chunk::voxelBytes() {
+    // Sections are always allocated. Copies made for snapshots are short-lived and not counted.
+    return sizeof(Chunk) + CHUNK_SECTIONS * sizeof(ChunkSection);
+}
@@ -1,34 +1,229 @@
 #pragma once
 
 #include "Block.h"
+#include "ChunkStage.h"
 #include <glm/glm.hpp>
+#include <array>
+#include <memory>
+#include <optional>
+#include <span>
 #include <vector>
 
 class World;
 
 constexpr int CHUNK_SIZE = 16;
 constexpr int CHUNK_HEIGHT = 16;
+constexpr int CHUNK_AREA = CHUNK_SIZE * CHUNK_SIZE;
+constexpr int CHUNK_VOLUME = CHUNK_AREA * CHUNK_HEIGHT;
+
+// Division rounding toward negative infinity, for the chunk holding a global coordinate
+// (floorDiv(gx, CHUNK_SIZE)). b must be positive.
+constexpr int floorDiv(int a, int b) {
+    int q = a / b;
+    if (a % b != 0 && a < 0) --q;
+    return q;
+}
+
+// Chunks are split vertically into sections, the unit of copy-on-write
+constexpr int SECTION_HEIGHT = 16;
+constexpr int CHUNK_SECTIONS = CHUNK_HEIGHT / SECTION_HEIGHT;
+constexpr int SECTION_VOLUME = CHUNK_AREA * SECTION_HEIGHT;
+static_assert(CHUNK_HEIGHT % SECTION_HEIGHT == 0, "CHUNK_HEIGHT must be a whole number of sections");
+static_assert(CHUNK_HEIGHT <= 255, "Column heights are stored as uint8_t");
+
+// Sections are summarized in bricks of BRICK_SIZE^3 voxels, one occupancy bit each
+constexpr int BRICK_SIZE = 4;
+static_assert((CHUNK_SIZE / BRICK_SIZE) * (CHUNK_SIZE / BRICK_SIZE) * (SECTION_HEIGHT / BRICK_SIZE) == 64,
+              "A section's brick occupancy must fill one uint64_t");
+// Bit of the brick holding (x, y, z) in its section's occupancy word; y is relative to
+// the section base
+constexpr int brickBit(int x, int y, int z) {
+    constexpr int BRICKS = CHUNK_SIZE / BRICK_SIZE;
+    return ((y / BRICK_SIZE) * BRICKS + z / BRICK_SIZE) * BRICKS + x / BRICK_SIZE;
+}
+
+// Light levels run 0-15 and are packed per voxel: sky light in the high nibble,
+// block light in the low nibble
+constexpr int MAX_LIGHT = 15;
+constexpr uint8_t FULL_SKY_LIGHT = MAX_LIGHT << 4;
+
+struct ChunkSection {
+    Block blocks[SECTION_VOLUME];
+    uint8_t light[SECTION_VOLUME];
+};
+
+// Immutable view of a chunk's blocks at the moment it was taken. It shares the
+// chunk's sections, so taking one is a handful of refcount increments, and later
+// edits to the chunk copy the section they touch instead of changing this view.
+// Safe to read from any thread without locking.
+class ChunkSnapshot {
+public:
+    glm::ivec2 position;
+
+    Block getBlock(int x, int y, int z) const;
+    uint8_t getLight(int x, int y, int z) const;
+    const ChunkSection& section(int index) const { return *sections[index]; }
+
+    // Copies of the chunk's column data; see Chunk::getSurfaceHeight
+    std::array<uint8_t, CHUNK_AREA> heightMap;
+    int minSolidY;
+    int maxSolidY;
+    // Brick occupancy words; see Chunk::isBrickOccupied
+    std::array<uint64_t, CHUNK_SECTIONS> occupancy;
+
+    // The same queries as on Chunk, so code can walk either
+    bool isEmpty() const { return minSolidY > maxSolidY; }
+    int getMinSolidY() const { return minSolidY; }
+    int getMaxSolidY() const { return maxSolidY; }
+    bool isBrickOccupied(int x, int y, int z) const {
+        return (occupancy[y / SECTION_HEIGHT] >> brickBit(x, y % SECTION_HEIGHT, z)) & 1;
+    }
+
+private:
+    friend class Chunk;
+    std::array<std::shared_ptr<const ChunkSection>, CHUNK_SECTIONS> sections;
+};
 
 class Chunk {
 public:
+    // Pure CPU data, so chunks can be built on any thread and without a GL context
     Chunk(glm::ivec2 position);
 
+    Chunk(const Chunk&) = delete;
+    Chunk& operator=(const Chunk&) = delete;
+
+    // Blocks are stored y-major: x is contiguous, then z, then y. Sections hold
+    // consecutive y ranges, so the same index applies inside a section with y
+    // taken relative to the section base.
+    static constexpr int blockIndex(int x, int y, int z) {
+        return (y * CHUNK_SIZE + z) * CHUNK_SIZE + x;
+    }
+
     Block getBlock(int x, int y, int z) const;
     void setBlock(int x, int y, int z, Block block);
 
-    // Generate mesh using world-aware neighbor checks (across chunk borders)
+    // Bulk writes: bounds are checked once per call. Ranges are half-open and clipped to the chunk.
+    // Edits do not schedule a new mesh themselves; see World::markMeshDirty.
+    void fillColumn(int x, int z, int yBegin, int yEnd, Block block);
+    void fillBox(const glm::ivec3& min, const glm::ivec3& max, Block block);
+    // Copy a full chunk of block IDs laid out in blockIndex order. Light is left as it
+    // was; relight the chunk if the blocks changed.
+    void copyFrom(std::span<const BlockType, CHUNK_VOLUME> ids);
+
+    // Direct write access to the sections in blockIndex order. The height map, solid
+    // bounds and brick occupancy are rebuilt when the edit goes out of scope, so keep it
+    // alive until all writes through its spans are done.
+    class BlockEdit {
+    public:
+        explicit BlockEdit(Chunk& chunk) : chunk(chunk) {}
+        ~BlockEdit() { chunk.updateHeightMap(); }
+        BlockEdit(const BlockEdit&) = delete;
+        BlockEdit& operator=(const BlockEdit&) = delete;
+
+        std::span<Block, SECTION_VOLUME> section(int sectionIndex) {
+            return std::span<Block, SECTION_VOLUME>(chunk.writableSection(sectionIndex).blocks);
+        }
+
+    private:
+        Chunk& chunk;
+    };
+    BlockEdit editBlocks() { return BlockEdit(*this); }
+    // Read access to one section, valid until the next edit of the chunk
+    const ChunkSection& section(int sectionIndex) const { return *sections[sectionIndex]; }
+    // The section as it is now, kept alive by the caller; the next edit copies it first
+    std::shared_ptr<const ChunkSection> shareSection(int sectionIndex) const { return sections[sectionIndex]; }
+
+    // Packed light (see FULL_SKY_LIGHT). Above the chunk is open sky, below it is dark.
+    uint8_t getLight(int x, int y, int z) const;
+    void setLight(int x, int y, int z, uint8_t light);
+    // Replace all light values, laid out in blockIndex order
+    void setLightData(std::span<const uint8_t, CHUNK_VOLUME> light);
+
+    // One past the highest solid block in the column, 0 for an all-air column
+    int getSurfaceHeight(int x, int z) const { return heightMap[z * CHUNK_SIZE + x]; }
+    // Layers outside [minSolidY, maxSolidY] hold no solid blocks (min > max when empty).
+    // The bounds may be loose after edits remove blocks, never too tight.
+    int getMinSolidY() const { return minSolidY; }
+    int getMaxSolidY() const { return maxSolidY; }
+    bool isEmpty() const { return minSolidY > maxSolidY; }
+    // False if the brick holding (x, y, z) is all air, so ray and box queries can skip it.
+    // Coordinates must be inside the chunk.
+    bool isBrickOccupied(int x, int y, int z) const {
+        return (occupancy[y / SECTION_HEIGHT] >> brickBit(x, y % SECTION_HEIGHT, z)) & 1;
+    }
+    // Rebuild the height map, bounds and brick occupancy from the block data
+    void updateHeightMap();
+
+    // Cheap immutable copy for readers on other threads (meshers, serializers).
+    // Must be called from the thread that edits this chunk.
+    ChunkSnapshot snapshot() const;
+    // Changes with every write to the blocks or light, so a holder of an older snapshot
+    // can tell whether it is still current
+    uint64_t getContentRevision() const { return contentRevision; }
+
+    // Snapshots of this chunk and its loaded neighbors, the input of a mesher job
+    std::array<std::optional<ChunkSnapshot>, 9> neighborhood(const World& world) const;
+    // Mesh from a padded copy of this chunk and its neighbors' borders (see ChunkMesher)
+    // and install it right away
     void generateMeshWithWorld(const World& world);
-    void render() const;
+    // Install vertices built elsewhere (ChunkMesher layout)
+    void setMesh(std::vector<float>&& vertices);
+    bool hasMesh() const { return meshRevision != 0; }
+    const std::vector<float>& getMeshVertices() const { return meshVertices; }
+    // Changes with every setMesh and is never reused, even by another chunk, so a
+    // renderer can tell whether the copy it uploaded is current
+    uint64_t getMeshRevision() const { return meshRevision; }
+    // Free the vertices; hasMesh() is false until the next setMesh
+    void clearMesh();
+
+    // Memory held by a chunk's blocks and light, the same for every chunk
+    static size_t voxelBytes();
+    size_t meshBytes() const { return meshVertices.capacity() * sizeof(float); }
 
-    bool needsMeshUpdate = true;
+    // Where the chunk is in the world's pipeline, and how long the step into each stage
+    // took the last time through it, in microseconds: for Requested and Uploaded the
+    // wait for a load job or for the upload budget, for the others the work itself.
+    ChunkStage stage = ChunkStage::Requested;
+    std::array<float, CHUNK_STAGE_COUNT> stageMicros{};
+    // Set while the chunk waits in the world's mesh dirty set
+    bool needsMeshUpdate = false;
+    // Nonzero while a mesher job for this chunk is in flight; identifies its result
+    uint64_t meshTicket = 0;
+    // Content revision of the snapshot the world last published for worker jobs
+    uint64_t publishedRevision = 0;
+    // Set by the world each time no observer keeps the chunk any more; tells the latest
+    // entry in its unload queue from older ones
+    uint64_t releaseSerial = 0;
     glm::ivec2 position;
     
 private:
-    Block blocks[CHUNK_SIZE][CHUNK_HEIGHT][CHUNK_SIZE];
-    unsigned int VAO, VBO;
+    // A section shared with a snapshot (use_count > 1) is cloned before it is written
+    std::array<std::shared_ptr<ChunkSection>, CHUNK_SECTIONS> sections;
+    std::array<uint8_t, CHUNK_AREA> heightMap{};
+    int minSolidY = CHUNK_HEIGHT;
+    int maxSolidY = -1;
+    // Bit brickBit(...) of a section's word is set while its brick holds a solid block.
+    // Exact: bricks are rescanned when an edit may have emptied them.
+    std::array<uint64_t, CHUNK_SECTIONS> occupancy{};
     std::vector<float> meshVertices;
-    size_t vertexCount = 0;
-    
-    void addFace(const glm::vec3& position, const glm::vec3& normal, BlockType type);
-    void uploadMeshToGPU();
+    uint64_t meshRevision = 0;
+    uint64_t contentRevision = 1;
+
+    ChunkSection& writableSection(int sectionIndex);
+    void updateColumn(int x, int z);
+    void updateColumnAfterFill(int x, int z, int yBegin, int yEnd, Block block);
+
+    // True if anything in the brick holding (x, y, z) is solid
+    bool brickHasSolid(int x, int y, int z) const;
+    // Update the brick's bit after block was written somewhere inside it
+    void updateBrickAfterFill(int x, int y, int z, Block block) {
+        uint64_t& bits = occupancy[y / SECTION_HEIGHT];
+        const uint64_t bit = uint64_t(1) << brickBit(x, y % SECTION_HEIGHT, z);
+        if (block.isSolid()) {
+            bits |= bit;
+        } else if ((bits & bit) && !brickHasSolid(x, y, z)) {
+            bits &= ~bit;
+        }
+    }
+    void updateOccupancy();
 };
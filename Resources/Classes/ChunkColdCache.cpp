@@ -0,0 +1,75 @@
+#include "ChunkColdCache.h"
+#include "ChunkCompression.h"
+#include <cstdlib>
+
+ChunkColdCache::ChunkColdCache(size_t maxBytes) : byteCap(maxBytes) {
+}
+
+int64_t ChunkColdCache::keyFor(const glm::ivec2& position) {
+    return (static_cast<int64_t>(position.x) << 32) | static_cast<uint32_t>(position.y);
+}
+
+size_t ChunkColdCache::entryBytes(const Entry& entry) {
+    // Payload plus a rough per-entry bookkeeping cost (map node, list node)
+    return entry.data.capacity() + sizeof(Entry) + 64;
+}
+
+void ChunkColdCache::store(const Chunk& chunk) {
+    std::vector<uint8_t> data = ChunkCompression::compress(chunk.snapshot());
+    data.shrink_to_fit();
+    put(chunk.position, std::move(data));
+}
+
+void ChunkColdCache::put(const glm::ivec2& position, std::vector<uint8_t>&& data) {
+    const int64_t key = keyFor(position);
+    auto existing = entries.find(key);
+    if (existing != entries.end()) erase(existing);
+
+    Entry entry;
+    entry.position = position;
+    entry.data = std::move(data);
+    const size_t bytes = entryBytes(entry);
+    if (bytes > byteCap) return;
+
+    lru.push_back(key);
+    entry.lruIt = std::prev(lru.end());
+    entries.emplace(key, std::move(entry));
+    usedBytes += bytes;
+
+    while (usedBytes > byteCap && !lru.empty()) {
+        erase(entries.find(lru.front()));
+        evictions++;
+    }
+}
+
+bool ChunkColdCache::take(const glm::ivec2& position, std::vector<uint8_t>& data) {
+    auto it = entries.find(keyFor(position));
+    if (it == entries.end()) {
+        misses++;
+        return false;
+    }
+
+    usedBytes -= entryBytes(it->second);
+    lru.erase(it->second.lruIt);
+    data = std::move(it->second.data);
+    entries.erase(it);
+    hits++;
+    return true;
+}
+
+void ChunkColdCache::clear() {
+    entries.clear();
+    lru.clear();
+    usedBytes = 0;
+}
+
+float ChunkColdCache::hitRate() const {
+    const uint64_t lookups = hits + misses;
+    return lookups == 0 ? 0.0f : static_cast<float>(hits) / static_cast<float>(lookups);
+}
+
+void ChunkColdCache::erase(std::unordered_map<int64_t, Entry>::iterator it) {
+    usedBytes -= entryBytes(it->second);
+    lru.erase(it->second.lruIt);
+    entries.erase(it);
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "Chunk.h"
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Keeps compressed block data for chunks that left the render distance but are still
+// inside the cold ring, so walking back restores them without running the generator.
+// Entries are evicted least-recently-stored first once the byte cap is exceeded.
+class ChunkColdCache {
+public:
+    explicit ChunkColdCache(size_t maxBytes);
+
+    void store(const Chunk& chunk);
+    // Store data that is already compressed, e.g. handed back after take()
+    void put(const glm::ivec2& position, std::vector<uint8_t>&& data);
+    // On a hit the compressed entry is moved into data and removed from the cache, so it
+    // can be decompressed off the calling thread (see ChunkCompression::decompress)
+    bool take(const glm::ivec2& position, std::vector<uint8_t>& data);
+
+    // Drop the entries whose position keep(position) rejects, e.g. those outside the
+    // cold ring around the player
+    template <typename Keep>
+    void dropOutside(Keep&& keep) {
+        for (auto it = entries.begin(); it != entries.end();) {
+            auto next = std::next(it);
+            if (!keep(it->second.position)) erase(it);
+            it = next;
+        }
+    }
+    void clear();
+
+    size_t sizeBytes() const { return usedBytes; }
+    size_t maxBytes() const { return byteCap; }
+    size_t entryCount() const { return entries.size(); }
+    uint64_t hitCount() const { return hits; }
+    uint64_t missCount() const { return misses; }
+    uint64_t evictionCount() const { return evictions; }
+    float hitRate() const;
+
+private:
+    struct Entry {
+        glm::ivec2 position;
+        std::vector<uint8_t> data;
+        std::list<int64_t>::iterator lruIt;
+    };
+
+    std::unordered_map<int64_t, Entry> entries;
+    std::list<int64_t> lru; // front = oldest
+    size_t byteCap;
+    size_t usedBytes = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+
+    static int64_t keyFor(const glm::ivec2& position);
+    static size_t entryBytes(const Entry& entry);
+    void erase(std::unordered_map<int64_t, Entry>::iterator it);
+};
@@ -0,0 +1,46 @@
+#include "ChunkCompression.h"
+#include <algorithm>
+
+std::vector<uint8_t> ChunkCompression::compress(const ChunkSnapshot& snapshot) {
+    std::vector<uint8_t> out;
+    out.reserve(256);
+
+    // Runs are cut at section boundaries; sections hold consecutive y ranges so the
+    // output is still in blockIndex order
+    for (int s = 0; s < CHUNK_SECTIONS; s++) {
+        const Block* blocks = snapshot.section(s).blocks;
+        int i = 0;
+        while (i < SECTION_VOLUME) {
+            const BlockType type = blocks[i].type;
+            int run = 1;
+            while (i + run < SECTION_VOLUME && run < 256 && blocks[i + run].type == type) {
+                run++;
+            }
+            out.push_back(static_cast<uint8_t>(type));
+            out.push_back(static_cast<uint8_t>(run - 1));
+            i += run;
+        }
+    }
+    return out;
+}
+
+bool ChunkCompression::decompress(std::span<const uint8_t> data, Chunk& chunk) {
+    if (data.size() % 2 != 0) return false;
+
+    // Validate total length first so a bad entry never leaves a half-written chunk
+    size_t total = 0;
+    for (size_t i = 1; i < data.size(); i += 2) {
+        total += static_cast<size_t>(data[i]) + 1;
+    }
+    if (total != CHUNK_VOLUME) return false;
+
+    std::array<BlockType, CHUNK_VOLUME> ids;
+    BlockType* out = ids.data();
+    for (size_t i = 0; i < data.size(); i += 2) {
+        const int run = data[i + 1] + 1;
+        std::fill(out, out + run, static_cast<BlockType>(data[i]));
+        out += run;
+    }
+    chunk.copyFrom(ids);
+    return true;
+}
\ No newline at end of file
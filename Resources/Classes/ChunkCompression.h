@@ -0,0 +1,17 @@
+#pragma once
+#include "Chunk.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Run-length codec for chunk block data. Blocks are encoded in blockIndex order
+// (y-major), so flat layers of air or stone collapse into a handful of runs.
+// Format: repeated (block ID byte, run length - 1 byte) pairs.
+class ChunkCompression {
+public:
+    // Works on a snapshot so it can run off the thread that edits the chunk
+    static std::vector<uint8_t> compress(const ChunkSnapshot& snapshot);
+
+    // Returns false (leaving the chunk untouched) if the data is malformed
+    static bool decompress(std::span<const uint8_t> data, Chunk& chunk);
+};
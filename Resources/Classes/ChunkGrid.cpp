@@ -0,0 +1,57 @@
+#include "ChunkGrid.h"
+
+namespace {
+    int shiftFor(int radius) {
+        int shift = 0;
+        while ((1 << shift) < 2 * radius + 1) shift++;
+        return shift;
+    }
+}
+
+ChunkGrid::ChunkGrid(int radius)
+    : gridRadius(radius), gridShift(shiftFor(radius)), gridSize(1 << gridShift),
+      slots(static_cast<size_t>(gridSize) * gridSize) {
+}
+
+void ChunkGrid::insert(std::unique_ptr<Chunk> chunk) {
+    const glm::ivec2 position = chunk->position;
+    Slot& slot = slots[slotIndex(position.x, position.y)];
+
+    if (slot.chunk) {
+        const glm::ivec2 displaced = slot.chunk->position;
+        overflow[overflowKey(displaced.x, displaced.y)] = std::move(slot.chunk);
+    }
+    residentCount++;
+    slot.chunk = std::move(chunk);
+    slot.generation = generationOf(position.x, position.y);
+}
+
+std::unique_ptr<Chunk> ChunkGrid::remove(int cx, int cz) {
+    Slot& slot = slots[slotIndex(cx, cz)];
+    if (!slot.chunk || slot.generation != generationOf(cx, cz)) {
+        auto it = overflow.find(overflowKey(cx, cz));
+        if (it == overflow.end()) return nullptr;
+        std::unique_ptr<Chunk> chunk = std::move(it->second);
+        overflow.erase(it);
+        residentCount--;
+        return chunk;
+    }
+
+    residentCount--;
+    slot.generation = {EMPTY, EMPTY};
+    return std::move(slot.chunk);
+}
+
+Chunk* ChunkGrid::findOverflow(int cx, int cz) {
+    auto it = overflow.find(overflowKey(cx, cz));
+    return it != overflow.end() ? it->second.get() : nullptr;
+}
+
+void ChunkGrid::clear() {
+    for (Slot& slot : slots) {
+        slot.chunk.reset();
+        slot.generation = {EMPTY, EMPTY};
+    }
+    overflow.clear();
+    residentCount = 0;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "Chunk.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Resident chunks in a fixed ring buffer covering a (2R+1) x (2R+1) window. A chunk at
+// (cx, cz) lives in slot (cx mod size, cz mod size), so lookups are plain array indexing.
+// Each slot also keeps the generation of its occupant, floor(c / size) per axis: the slot
+// is shared by every coordinate that wraps onto it, and the generation tells them apart.
+// The side is rounded up to a power of two so both come from a mask and a shift instead
+// of a division. When the window moves, chunks leaving one edge free the slots that
+// chunks entering the opposite edge need, and nothing already resident is moved or copied.
+//
+// Chunks outside the window (other observers' regions, or far chunks still waiting to be
+// unloaded) cannot all have a slot. The newest chunk takes the slot and the one it
+// displaces moves to an overflow hash map, which lookups only consult when it is not empty.
+class ChunkGrid {
+public:
+    explicit ChunkGrid(int radius);
+
+    int radius() const { return gridRadius; }
+    // Slots per side, at least 2 * radius + 1
+    int size() const { return gridSize; }
+    size_t count() const { return residentCount; }
+    // Resident chunks without a slot of their own
+    size_t overflowCount() const { return overflow.size(); }
+
+    Chunk* find(int cx, int cz) {
+        const Slot& slot = slots[slotIndex(cx, cz)];
+        if (slot.generation == generationOf(cx, cz)) return slot.chunk.get();
+        return overflow.empty() ? nullptr : findOverflow(cx, cz);
+    }
+    const Chunk* find(int cx, int cz) const {
+        return const_cast<ChunkGrid*>(this)->find(cx, cz);
+    }
+    bool contains(int cx, int cz) const { return find(cx, cz) != nullptr; }
+
+    // Take ownership of a chunk at its own position, which must not be resident yet.
+    // A different chunk already in the slot moves to the overflow map.
+    void insert(std::unique_ptr<Chunk> chunk);
+    // Give up ownership of the chunk at (cx, cz), or nullptr if it is not resident
+    std::unique_ptr<Chunk> remove(int cx, int cz);
+    void clear();
+
+    // Visit every resident chunk, in slot order and then the overflow
+    template <typename Fn>
+    void forEach(Fn&& fn) {
+        for (Slot& slot : slots) {
+            if (slot.chunk) fn(*slot.chunk);
+        }
+        for (auto& [key, chunk] : overflow) fn(*chunk);
+    }
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const Slot& slot : slots) {
+            if (slot.chunk) fn(static_cast<const Chunk&>(*slot.chunk));
+        }
+        for (const auto& [key, chunk] : overflow) fn(static_cast<const Chunk&>(*chunk));
+    }
+
+private:
+    struct Slot {
+        std::unique_ptr<Chunk> chunk;
+        glm::ivec2 generation{EMPTY, EMPTY};
+    };
+
+    // No real coordinate divides down to this
+    static constexpr int EMPTY = INT32_MIN;
+
+    int gridRadius;
+    int gridShift;
+    int gridSize;
+    std::vector<Slot> slots;
+    std::unordered_map<int64_t, std::unique_ptr<Chunk>> overflow;
+    size_t residentCount = 0;
+
+    static int64_t overflowKey(int cx, int cz) {
+        return (static_cast<int64_t>(cx) << 32) | static_cast<uint32_t>(cz);
+    }
+    Chunk* findOverflow(int cx, int cz);
+
+    // Arithmetic shift right is floor division, so negative coordinates wrap correctly
+    glm::ivec2 generationOf(int cx, int cz) const {
+        return {cx >> gridShift, cz >> gridShift};
+    }
+    size_t slotIndex(int cx, int cz) const {
+        const int mask = gridSize - 1;
+        return (static_cast<size_t>(cz & mask) << gridShift) | static_cast<size_t>(cx & mask);
+    }
+};
@@ -0,0 +1,163 @@
+#include "ChunkMesher.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    void addFace(std::vector<float>& vertices, const glm::vec3& position, const glm::vec3& normal, BlockType type, uint8_t light) {
+        const BlockColor& color = BlockRegistry::color(type);
+        const float skyLight = static_cast<float>(light >> 4) / MAX_LIGHT;
+        const float blockLight = static_cast<float>(light & 0x0F) / MAX_LIGHT;
+
+        // Small offset to prevent z-fighting at chunk boundaries
+        const float epsilon = 0.001f;
+        const float offsetX = normal.x * epsilon;
+        const float offsetY = normal.y * epsilon;
+        const float offsetZ = normal.z * epsilon;
+
+        const float x = position.x + offsetX;
+        const float y = position.y + offsetY;
+        const float z = position.z + offsetZ;
+
+        auto pushVertex = [&](float px, float py, float pz) {
+            vertices.push_back(px);
+            vertices.push_back(py);
+            vertices.push_back(pz);
+            vertices.push_back(normal.x);
+            vertices.push_back(normal.y);
+            vertices.push_back(normal.z);
+            vertices.push_back(color.r);
+            vertices.push_back(color.g);
+            vertices.push_back(color.b);
+            vertices.push_back(skyLight);
+            vertices.push_back(blockLight);
+        };
+
+        // Build two triangles (A,B,C) and (A,C,D) with CCW winding facing the normal
+        if (normal.x == 1.0f) {
+            // Right face (x+1)
+            // A: (x+1,y,  z+1), B: (x+1,y+1,z+1), C: (x+1,y+1,z), D: (x+1,y,  z)
+            pushVertex(x+1, y,   z+1);
+            pushVertex(x+1, y+1, z+1);
+            pushVertex(x+1, y+1, z  );
+            pushVertex(x+1, y,   z+1);
+            pushVertex(x+1, y+1, z  );
+            pushVertex(x+1, y,   z  );
+        } else if (normal.x == -1.0f) {
+            // Left face (x)
+            // A: (x,y,  z), B: (x,y+1,z), C: (x,y+1,z+1), D: (x,y,  z+1)
+            pushVertex(x, y,   z  );
+            pushVertex(x, y+1, z  );
+            pushVertex(x, y+1, z+1);
+            pushVertex(x, y,   z  );
+            pushVertex(x, y+1, z+1);
+            pushVertex(x, y,   z+1);
+        } else if (normal.y == 1.0f) {
+            // Top face (y+1)
+            // A: (x,  y+1,z+1), B: (x+1,y+1,z+1), C: (x+1,y+1,z), D: (x,  y+1,z)
+            pushVertex(x,   y+1, z+1);
+            pushVertex(x+1, y+1, z+1);
+            pushVertex(x+1, y+1, z  );
+            pushVertex(x,   y+1, z+1);
+            pushVertex(x+1, y+1, z  );
+            pushVertex(x,   y+1, z  );
+        } else if (normal.y == -1.0f) {
+            // Bottom face (y)
+            // A: (x,  y,z), B: (x+1,y,z), C: (x+1,y,z+1), D: (x,  y,z+1)
+            pushVertex(x,   y, z  );
+            pushVertex(x+1, y, z  );
+            pushVertex(x+1, y, z+1);
+            pushVertex(x,   y, z  );
+            pushVertex(x+1, y, z+1);
+            pushVertex(x,   y, z+1);
+        } else if (normal.z == 1.0f) {
+            // Front face (z+1)
+            // A: (x,  y,  z+1), B: (x+1,y,  z+1), C: (x+1,y+1,z+1), D: (x,  y+1,z+1)
+            pushVertex(x,   y,   z+1);
+            pushVertex(x+1, y,   z+1);
+            pushVertex(x+1, y+1, z+1);
+            pushVertex(x,   y,   z+1);
+            pushVertex(x+1, y+1, z+1);
+            pushVertex(x,   y+1, z+1);
+        } else if (normal.z == -1.0f) {
+            // Back face (z)
+            // A: (x+1,y,  z), B: (x+1,y+1,z), C: (x,  y+1,z), D: (x,  y,  z)
+            pushVertex(x+1, y,   z);
+            pushVertex(x+1, y+1, z);
+            pushVertex(x,   y+1, z);
+            pushVertex(x+1, y,   z);
+            pushVertex(x,   y+1, z);
+            pushVertex(x,   y,   z);
+        }
+    }
+}
+
+void PaddedChunk::gather(const std::array<std::optional<ChunkSnapshot>, 9>& around) {
+    static_assert(sizeof(Block) == sizeof(BlockType), "Block must stay a plain BlockType wrapper");
+    const ChunkSnapshot& center = *around[4];
+    position = center.position;
+    minSolidY = center.minSolidY;
+    maxSolidY = center.maxSolidY;
+
+    // Below the world is dark, above it is open sky; both are air
+    const int layer = SIDE * SIDE;
+    std::fill_n(blocks.begin(), layer, BlockType::AIR);
+    std::fill_n(light.begin(), layer, uint8_t{0});
+    std::fill_n(blocks.begin() + index(-1, CHUNK_HEIGHT, -1), layer, BlockType::AIR);
+    std::fill_n(light.begin() + index(-1, CHUNK_HEIGHT, -1), layer, FULL_SKY_LIGHT);
+
+    // Each padded row is a piece of three chunks: the last column of the -x neighbor,
+    // a full row of the middle one and the first column of the +x neighbor
+    for (int y = 0; y < CHUNK_HEIGHT; y++) {
+        const int section = y / SECTION_HEIGHT;
+        const int sectionY = y % SECTION_HEIGHT;
+        for (int z = -1; z <= CHUNK_SIZE; z++) {
+            const int row = z < 0 ? 0 : (z < CHUNK_SIZE ? 1 : 2);
+            const int localZ = z - (row - 1) * CHUNK_SIZE;
+            const int from = Chunk::blockIndex(0, sectionY, localZ);
+            const int target = index(0, y, z);
+
+            if (const auto& source = around[row * 3 + 1]) {
+                const ChunkSection& data = source->section(section);
+                std::memcpy(blocks.data() + target, data.blocks + from, CHUNK_SIZE);
+                std::memcpy(light.data() + target, data.light + from, CHUNK_SIZE);
+            } else {
+                std::fill_n(blocks.begin() + target, CHUNK_SIZE, BlockType::AIR);
+                std::fill_n(light.begin() + target, CHUNK_SIZE, FULL_SKY_LIGHT);
+            }
+
+            const auto& left = around[row * 3];
+            const auto& right = around[row * 3 + 2];
+            blocks[target - 1] = left ? left->section(section).blocks[from + CHUNK_SIZE - 1].type : BlockType::AIR;
+            light[target - 1] = left ? left->section(section).light[from + CHUNK_SIZE - 1] : FULL_SKY_LIGHT;
+            blocks[target + CHUNK_SIZE] = right ? right->section(section).blocks[from].type : BlockType::AIR;
+            light[target + CHUNK_SIZE] = right ? right->section(section).light[from] : FULL_SKY_LIGHT;
+        }
+    }
+}
+
+void ChunkMesher::buildMesh(const PaddedChunk& padded, std::vector<float>& vertices) {
+    vertices.clear();
+
+    static const glm::vec3 normals[6] = {
+        {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 1, 0}, {0, 0, -1}, {0, 0, 1}
+    };
+
+    // Layers outside the solid bounds are all air and emit nothing. Every neighbor is
+    // inside the padded array, so the loop needs no bounds checks or lookups.
+    for (int y = padded.minSolidY; y <= padded.maxSolidY; y++) {
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            int i = PaddedChunk::index(0, y, z);
+            for (int x = 0; x < CHUNK_SIZE; x++, i++) {
+                const BlockType type = padded.blocks[i];
+                if (!BlockRegistry::isSolid(type)) continue;
+
+                for (int d = 0; d < 6; d++) {
+                    // A face is hidden only when the neighbor is opaque, and lit by the voxel it faces
+                    const int n = i + PaddedChunk::FACE_OFFSETS[d];
+                    if (BlockRegistry::isOpaque(padded.blocks[n])) continue;
+                    addFace(vertices, glm::vec3(x, y, z), normals[d], type, padded.light[n]);
+                }
+            }
+        }
+    }
+}
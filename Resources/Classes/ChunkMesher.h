@@ -0,0 +1,45 @@
+#pragma once
+#include "Chunk.h"
+#include <array>
+#include <optional>
+#include <vector>
+
+// One chunk plus a one-voxel border copied from its eight horizontal neighbors, so
+// every voxel the mesher looks at (faces, and the corners AO would need) is a fixed
+// offset away in one flat array. Missing neighbors read as open-sky air, below the
+// world is dark air and above it is open sky, matching World::getBlockGlobal and
+// World::getLightGlobal.
+struct PaddedChunk {
+    static constexpr int SIDE = CHUNK_SIZE + 2;
+    static constexpr int LAYERS = CHUNK_HEIGHT + 2;
+    static constexpr int VOLUME = SIDE * SIDE * LAYERS;
+
+    // Chunk-local coordinates, each in [-1, size]; same axis order as Chunk::blockIndex
+    static constexpr int index(int x, int y, int z) {
+        return ((y + 1) * SIDE + (z + 1)) * SIDE + (x + 1);
+    }
+    // Index steps to the six face neighbors: -x, +x, -y, +y, -z, +z
+    static constexpr int FACE_OFFSETS[6] = {-1, 1, -SIDE * SIDE, SIDE * SIDE, -SIDE, SIDE};
+
+    glm::ivec2 position;
+    int minSolidY;
+    int maxSolidY;
+    std::array<BlockType, VOLUME> blocks;
+    std::array<uint8_t, VOLUME> light;
+
+    // Copy the center chunk and the border in one pass. around is the 3x3 neighborhood
+    // indexed (dz + 1) * 3 + (dx + 1), as returned by Chunk::neighborhood; the center
+    // (index 4) must be set, the rest are empty for chunks that are not loaded.
+    void gather(const std::array<std::optional<ChunkSnapshot>, 9>& around);
+};
+
+// Builds chunk meshes from padded copies. Touches no World or GL state, so it can run
+// on any thread.
+class ChunkMesher {
+public:
+    // position(3) + normal(3) + color(3) + light(2)
+    static constexpr int VERTEX_FLOATS = 11;
+
+    // Replace vertices with the visible faces of the padded chunk's center
+    static void buildMesh(const PaddedChunk& padded, std::vector<float>& vertices);
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// Steps a chunk goes through from being asked for to being drawn, in order. The first
+// three run inside one load job, Lit is reached when the world takes the chunk in, and
+// the last two belong to the mesher. An edit or a dropped mesh sends a chunk back to Lit.
+enum class ChunkStage : uint8_t {
+    Requested, // Waiting in the load queue or for its job to finish
+    Generated, // Blocks from the noise, or from the cold cache with edits included
+    Decorated, // Saved edits replayed over the generated blocks
+    Lit,       // Light computed and stitched with the loaded neighbors; resident from here on
+    Meshed,    // Current mesh built, waiting for the upload budget
+    Uploaded,  // Current mesh installed for the renderer
+};
+constexpr int CHUNK_STAGE_COUNT = 6;
+
+constexpr int stageIndex(ChunkStage stage) { return static_cast<int>(stage); }
+
+constexpr std::array<const char*, CHUNK_STAGE_COUNT> CHUNK_STAGE_NAMES = {
+    "requested", "generated", "decorated", "lit", "meshed", "uploaded",
+};
+
+// Which neighbors a stage reads or writes besides the chunk itself
+enum class StageNeighbors : uint8_t {
+    None,
+    Edges, // The four chunks sharing an edge
+    All,   // All eight surrounding chunks
+};
+
+// What the neighbors of a chunk must have reached before the chunk may enter a stage.
+// A stage that touches neighbor data has to list them here, so the scheduler never
+// runs it against a neighbor that is not ready yet.
+struct StageDependency {
+    StageNeighbors neighbors;
+    ChunkStage neighborsAt;
+};
+
+constexpr std::array<StageDependency, CHUNK_STAGE_COUNT> STAGE_DEPENDENCIES = {{
+    {StageNeighbors::None, ChunkStage::Requested},  // Requested
+    {StageNeighbors::None, ChunkStage::Requested},  // Generated: noise needs no neighbors
+    {StageNeighbors::None, ChunkStage::Requested},  // Decorated: edits stay inside the chunk
+    // Light crossing a border is stitched from whichever side arrives second, so any
+    // subset of neighbors will do
+    {StageNeighbors::None, ChunkStage::Requested},  // Lit
+    // Faces on the border are culled against the neighbor's blocks and shaded with its
+    // light. Only first meshes wait: drawn chunks are remeshed after edits regardless.
+    {StageNeighbors::Edges, ChunkStage::Lit},        // Meshed
+    {StageNeighbors::None, ChunkStage::Requested},  // Uploaded
+}};
@@ -0,0 +1,47 @@
+#include "ConcurrentChunkMap.h"
+#include <mutex>
+
+std::shared_ptr<const ChunkSnapshot> ConcurrentChunkMap::find(int cx, int cz) const {
+    const int64_t key = keyFor(cx, cz);
+    const Shard& shard = shards[shardOf(key)];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.chunks.find(key);
+    return it != shard.chunks.end() ? it->second : nullptr;
+}
+
+void ConcurrentChunkMap::publish(std::shared_ptr<const ChunkSnapshot> snapshot) {
+    const int64_t key = keyFor(snapshot->position.x, snapshot->position.y);
+    Shard& shard = shards[shardOf(key)];
+    // The old snapshot is released after the lock, in case this was its last reference
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.chunks[key].swap(snapshot);
+    lock.unlock();
+}
+
+std::shared_ptr<const ChunkSnapshot> ConcurrentChunkMap::retire(int cx, int cz) {
+    const int64_t key = keyFor(cx, cz);
+    Shard& shard = shards[shardOf(key)];
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.chunks.find(key);
+    if (it == shard.chunks.end()) return nullptr;
+    std::shared_ptr<const ChunkSnapshot> snapshot = std::move(it->second);
+    shard.chunks.erase(it);
+    return snapshot;
+}
+
+void ConcurrentChunkMap::clear() {
+    for (Shard& shard : shards) {
+        std::unordered_map<int64_t, std::shared_ptr<const ChunkSnapshot>> retired;
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        retired.swap(shard.chunks);
+    }
+}
+
+size_t ConcurrentChunkMap::count() const {
+    size_t total = 0;
+    for (const Shard& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.chunks.size();
+    }
+    return total;
+}
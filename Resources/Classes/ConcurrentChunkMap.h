@@ -0,0 +1,47 @@
+#pragma once
+#include "Chunk.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+// Chunk snapshots published for lookups from any thread. The map is split into SHARDS
+// independently locked hash maps, picked by a hash of the chunk coordinates, so threads
+// looking up or publishing different chunks rarely touch the same lock; lookups only take
+// a shard's lock in shared mode. Entries are immutable snapshots handed out as
+// shared_ptr: replacing or retiring one never pulls data out from under a reader, which
+// keeps what it found alive until it lets go.
+class ConcurrentChunkMap {
+public:
+    static constexpr int SHARD_BITS = 6;
+    static constexpr size_t SHARDS = size_t(1) << SHARD_BITS;
+
+    // Latest snapshot published at (cx, cz), or nullptr
+    std::shared_ptr<const ChunkSnapshot> find(int cx, int cz) const;
+    // Add the snapshot at its position, replacing whatever was published there
+    void publish(std::shared_ptr<const ChunkSnapshot> snapshot);
+    // Remove the snapshot at (cx, cz) and return it, or nullptr if there was none
+    std::shared_ptr<const ChunkSnapshot> retire(int cx, int cz);
+    void clear();
+
+    // Sum over the shards, which may change while they are counted
+    size_t count() const;
+
+private:
+    // A cache line each, so readers of neighboring shards do not share one
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<int64_t, std::shared_ptr<const ChunkSnapshot>> chunks;
+    };
+    std::array<Shard, SHARDS> shards;
+
+    static int64_t keyFor(int cx, int cz) {
+        return (static_cast<int64_t>(cx) << 32) | static_cast<uint32_t>(cz);
+    }
+    // Neighboring chunks land on unrelated shards
+    static size_t shardOf(int64_t key) {
+        uint64_t h = static_cast<uint64_t>(key) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h >> (64 - SHARD_BITS));
+    }
+};
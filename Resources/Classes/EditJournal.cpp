@@ -0,0 +1,268 @@
+#include "EditJournal.h"
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+namespace {
+    // Log record: chunk x, chunk z (int32), block index (uint16), block ID, check byte
+    constexpr size_t RECORD_BYTES = 12;
+    // Delta list entry: block index (uint16), block ID
+    constexpr size_t DELTA_BYTES = 3;
+    static_assert(CHUNK_VOLUME <= 65536, "Block indices must fit in 16 bits");
+
+    uint8_t checkByte(const uint8_t* record) {
+        uint8_t check = 0xA5;
+        for (size_t i = 0; i < RECORD_BYTES - 1; i++) check = static_cast<uint8_t>((check ^ record[i]) * 31);
+        return check;
+    }
+
+    bool writeAll(int fd, const uint8_t* bytes, size_t size) {
+        while (size > 0) {
+            const ssize_t written = ::write(fd, bytes, size);
+            if (written <= 0) return false;
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+}
+
+EditJournal::EditJournal(std::filesystem::path directory)
+    : directory(std::move(directory)), logPath(this->directory / "edits.log"), compacted(this->directory) {
+    replayLog();
+    logFd = ::open(logPath.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (logFd < 0) {
+        std::cerr << "Cannot open edit log " << logPath << std::endl;
+    }
+}
+
+EditJournal::~EditJournal() {
+    flush();
+    if (logFd >= 0) ::close(logFd);
+}
+
+int64_t EditJournal::keyFor(const glm::ivec2& position) {
+    return (static_cast<int64_t>(position.x) << 32) | static_cast<uint32_t>(position.y);
+}
+
+void EditJournal::appendRecord(std::vector<uint8_t>& out, const glm::ivec2& chunk, uint16_t index, BlockType type) {
+    uint8_t record[RECORD_BYTES];
+    const int32_t x = chunk.x;
+    const int32_t z = chunk.y;
+    std::memcpy(record, &x, 4);
+    std::memcpy(record + 4, &z, 4);
+    std::memcpy(record + 8, &index, 2);
+    record[10] = static_cast<uint8_t>(type);
+    record[11] = checkByte(record);
+    out.insert(out.end(), record, record + RECORD_BYTES);
+}
+
+std::vector<uint8_t> EditJournal::encodeDeltas(const Deltas& deltas) {
+    std::vector<uint8_t> data;
+    data.reserve(deltas.size() * DELTA_BYTES);
+    for (const auto& [index, type] : deltas) {
+        data.push_back(static_cast<uint8_t>(index & 0xFF));
+        data.push_back(static_cast<uint8_t>(index >> 8));
+        data.push_back(static_cast<uint8_t>(type));
+    }
+    return data;
+}
+
+bool EditJournal::decodeDeltas(std::span<const uint8_t> data, Deltas& deltas) {
+    if (data.size() % DELTA_BYTES != 0) return false;
+    for (size_t i = 0; i < data.size(); i += DELTA_BYTES) {
+        const uint16_t index = static_cast<uint16_t>(data[i] | (data[i + 1] << 8));
+        if (index >= CHUNK_VOLUME) return false;
+        deltas[index] = static_cast<BlockType>(data[i + 2]);
+    }
+    return true;
+}
+
+void EditJournal::replayLog() {
+    const int fd = ::open(logPath.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    // A torn or corrupt tail ends the replay; everything before it was synced whole
+    uint8_t record[RECORD_BYTES];
+    while (::read(fd, record, RECORD_BYTES) == static_cast<ssize_t>(RECORD_BYTES)) {
+        if (record[11] != checkByte(record)) break;
+        int32_t x, z;
+        uint16_t index;
+        std::memcpy(&x, record, 4);
+        std::memcpy(&z, record + 4, 4);
+        std::memcpy(&index, record + 8, 2);
+        if (index >= CHUNK_VOLUME) break;
+
+        const glm::ivec2 position(x, z);
+        ChunkEdits& edits = recent[keyFor(position)];
+        edits.position = position;
+        edits.deltas[index] = static_cast<BlockType>(record[10]);
+        logRecords++;
+    }
+    ::close(fd);
+
+    // Drop the bad tail so new records are not appended after it
+    std::error_code error;
+    std::filesystem::resize_file(logPath, logRecords * RECORD_BYTES, error);
+}
+
+void EditJournal::record(const glm::ivec2& chunk, int index, Block block) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ChunkEdits& edits = recent[keyFor(chunk)];
+    edits.position = chunk;
+    edits.deltas[static_cast<uint16_t>(index)] = block.type;
+    appendRecord(unflushed, chunk, static_cast<uint16_t>(index), block.type);
+    stats.editsRecorded++;
+}
+
+void EditJournal::apply(Chunk& chunk) {
+    const int64_t key = keyFor(chunk.position);
+    Deltas deltas;
+    std::vector<uint8_t> data;
+    // Recent edits are copied before the delta list is read. If a compaction moved edits
+    // from one to the other in between, both are read again.
+    for (bool consistent = false; !consistent;) {
+        Deltas latest;
+        uint64_t foldsBefore;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            foldsBefore = folds;
+            auto it = recent.find(key);
+            if (it != recent.end()) latest = it->second.deltas;
+        }
+
+        deltas.clear();
+        if (compacted.load(chunk.position, data) && !decodeDeltas(data, deltas)) {
+            std::cerr << "Corrupt edit list for chunk " << chunk.position.x << ", " << chunk.position.y << std::endl;
+            deltas.clear();
+        }
+        for (const auto& [index, type] : latest) deltas[index] = type;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        consistent = folds == foldsBefore;
+    }
+
+    for (const auto& [index, type] : deltas) {
+        const int x = index % CHUNK_SIZE;
+        const int z = (index / CHUNK_SIZE) % CHUNK_SIZE;
+        const int y = index / CHUNK_AREA;
+        chunk.setBlock(x, y, z, Block{type});
+    }
+}
+
+void EditJournal::flush() {
+    std::lock_guard<std::mutex> logLock(logMutex);
+    flushLocked();
+}
+
+void EditJournal::flushLocked() {
+    std::vector<uint8_t> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch.swap(unflushed);
+    }
+    if (batch.empty() || logFd < 0) return;
+
+    if (!writeAll(logFd, batch.data(), batch.size()) || ::fsync(logFd) != 0) {
+        std::cerr << "Failed to write edit log " << logPath << std::endl;
+        return;
+    }
+    logRecords += batch.size() / RECORD_BYTES;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.recordsWritten += batch.size() / RECORD_BYTES;
+    stats.bytesWritten += batch.size();
+}
+
+bool EditJournal::hasUnflushedEdits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return !unflushed.empty();
+}
+
+bool EditJournal::needsCompaction() const {
+    return logRecords >= COMPACT_RECORDS;
+}
+
+void EditJournal::compact() {
+    std::lock_guard<std::mutex> logLock(logMutex);
+    flushLocked();
+
+    std::unordered_map<int64_t, ChunkEdits> folding;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        folding = recent;
+    }
+    if (folding.empty()) return;
+
+    // Merge into each chunk's delta list and make the region files durable
+    const uint64_t regionBytesBefore = compacted.getStats().bytesWritten;
+    std::vector<uint8_t> data;
+    for (const auto& [key, edits] : folding) {
+        Deltas deltas;
+        if (compacted.load(edits.position, data) && !decodeDeltas(data, deltas)) deltas.clear();
+        for (const auto& [index, type] : edits.deltas) deltas[index] = type;
+        compacted.save(edits.position, encodeDeltas(deltas));
+    }
+    compacted.flush();
+
+    // Forget folded edits unless they changed again meanwhile. What is left covers
+    // everything recorded since the copy, including records not yet flushed.
+    std::vector<uint8_t> remaining;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& [key, edits] : folding) {
+            auto it = recent.find(key);
+            if (it == recent.end()) continue;
+            for (const auto& [index, type] : edits.deltas) {
+                auto delta = it->second.deltas.find(index);
+                if (delta != it->second.deltas.end() && delta->second == type) it->second.deltas.erase(delta);
+            }
+            if (it->second.deltas.empty()) recent.erase(it);
+        }
+        for (const auto& [key, edits] : recent) {
+            for (const auto& [index, type] : edits.deltas) appendRecord(remaining, edits.position, index, type);
+        }
+        unflushed.clear();
+        folds++;
+        stats.compactions++;
+        stats.chunksCompacted += folding.size();
+        stats.bytesWritten += compacted.getStats().bytesWritten - regionBytesBefore;
+    }
+
+    if (!rewriteLog(remaining)) {
+        // The old log still replays to the same blocks; keep appending to it
+        std::cerr << "Failed to rewrite edit log " << logPath << std::endl;
+        std::lock_guard<std::mutex> lock(mutex);
+        unflushed.insert(unflushed.begin(), remaining.begin(), remaining.end());
+        return;
+    }
+    logRecords = remaining.size() / RECORD_BYTES;
+}
+
+bool EditJournal::rewriteLog(const std::vector<uint8_t>& records) {
+    const std::filesystem::path tempPath = logPath.string() + ".tmp";
+    const int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0) return false;
+    if (!writeAll(fd, records.data(), records.size()) || ::fsync(fd) != 0 ||
+        std::rename(tempPath.c_str(), logPath.c_str()) != 0) {
+        ::close(fd);
+        std::filesystem::remove(tempPath);
+        return false;
+    }
+
+    // The renamed file is the log now; make the rename durable before dropping the old one
+    const int dirFd = ::open(directory.c_str(), O_RDONLY);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    if (logFd >= 0) ::close(logFd);
+    logFd = fd;
+    return true;
+}
+
+EditJournalStats EditJournal::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
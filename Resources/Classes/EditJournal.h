@@ -0,0 +1,91 @@
+#pragma once
+#include "Chunk.h"
+#include "RegionStore.h"
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+struct EditJournalStats {
+    uint64_t editsRecorded = 0;
+    uint64_t recordsWritten = 0;  // Records appended to the log
+    uint64_t bytesWritten = 0;    // Log appends plus region writes by compaction
+    uint64_t compactions = 0;
+    uint64_t chunksCompacted = 0;
+};
+
+// Block edits saved as deltas over the procedural terrain: a chunk is loaded by
+// generating it and replaying its edits, so what is written to disk scales with the
+// number of edits rather than with the number of chunks visited.
+//
+// Edits are appended to a log (edits.log) by flush(). compact() folds the log into one
+// delta list per chunk, stored in region files (see RegionStore), and rewrites the log
+// with only the edits made while it ran. Replaying an edit twice is harmless, so a
+// crash at any point loses at most the edits not yet flushed.
+//
+// All methods may be called from any thread; flush() and compact() are meant to run on
+// a worker.
+class EditJournal {
+public:
+    explicit EditJournal(std::filesystem::path directory);
+    // Flushes whatever is still unwritten
+    ~EditJournal();
+
+    EditJournal(const EditJournal&) = delete;
+    EditJournal& operator=(const EditJournal&) = delete;
+
+    // index is Chunk::blockIndex over the whole chunk height
+    void record(const glm::ivec2& chunk, int index, Block block);
+    // Apply every edit made to the chunk, on top of freshly generated blocks
+    void apply(Chunk& chunk);
+
+    // Append recorded edits to the log and sync it
+    void flush();
+    bool hasUnflushedEdits() const;
+    // Fold the log into per-chunk delta lists
+    void compact();
+    bool needsCompaction() const;
+
+    EditJournalStats getStats() const;
+
+private:
+    // Block ID by index, kept sorted so delta lists encode in index order
+    using Deltas = std::map<uint16_t, BlockType>;
+    struct ChunkEdits {
+        glm::ivec2 position;
+        Deltas deltas;
+    };
+
+    std::filesystem::path directory;
+    std::filesystem::path logPath;
+    RegionStore compacted;
+
+    // Lock order: logMutex before mutex. mutex is never held across log I/O.
+    std::mutex logMutex;
+    int logFd = -1;
+    std::atomic<size_t> logRecords{0};
+
+    mutable std::mutex mutex;
+    // Edits in the log (or about to be) that compaction has not folded in yet
+    std::unordered_map<int64_t, ChunkEdits> recent;
+    std::vector<uint8_t> unflushed;
+    uint64_t folds = 0; // Bumped each time compaction drops folded edits from recent
+    EditJournalStats stats;
+
+    // Compact once the log holds this many records
+    static constexpr size_t COMPACT_RECORDS = 16 * 1024;
+
+    static int64_t keyFor(const glm::ivec2& position);
+    static void appendRecord(std::vector<uint8_t>& out, const glm::ivec2& chunk, uint16_t index, BlockType type);
+    static std::vector<uint8_t> encodeDeltas(const Deltas& deltas);
+    static bool decodeDeltas(std::span<const uint8_t> data, Deltas& deltas);
+
+    void replayLog();
+    void flushLocked();
+    bool rewriteLog(const std::vector<uint8_t>& records);
+};
@@ -0,0 +1,37 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <cmath>
+
+FrameStats::FrameStats(size_t window) : samples(window, 0.0) {
+}
+
+void FrameStats::addFrame(double milliseconds) {
+    samples[next] = milliseconds;
+    next = (next + 1) % samples.size();
+    filled = std::min(filled + 1, samples.size());
+}
+
+void FrameStats::clear() {
+    next = 0;
+    filled = 0;
+}
+
+double FrameStats::average() const {
+    if (filled == 0) return 0.0;
+    double total = 0.0;
+    for (size_t i = 0; i < filled; i++) total += samples[i];
+    return total / filled;
+}
+
+double FrameStats::max() const {
+    if (filled == 0) return 0.0;
+    return *std::max_element(samples.begin(), samples.begin() + filled);
+}
+
+double FrameStats::percentile(double p) const {
+    if (filled == 0) return 0.0;
+    std::vector<double> sorted(samples.begin(), samples.begin() + filled);
+    const size_t rank = std::min(filled - 1, static_cast<size_t>(std::ceil(p * filled)) - (p > 0.0 ? 1 : 0));
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+    return sorted[rank];
+}
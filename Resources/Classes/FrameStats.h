@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Rolling window of recent frame times. Averages hide hitches, so this reports
+// percentiles: a p99 well above the median means the frame rate stutters.
+class FrameStats {
+public:
+    explicit FrameStats(size_t window = 600);
+
+    void addFrame(double milliseconds);
+    void clear();
+
+    size_t count() const { return filled; }
+    double average() const;
+    double max() const;
+    // p in [0, 1]; sorts a copy of the window
+    double percentile(double p) const;
+
+private:
+    std::vector<double> samples;
+    size_t next = 0;
+    size_t filled = 0;
+};
@@ -0,0 +1,257 @@
+#include "LightEngine.h"
+#include "World.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    constexpr int SKY = 0;
+    constexpr int BLOCK = 1;
+
+    // -x, +x, -y, +y, -z, +z
+    constexpr int DX[6] = {-1, 1, 0, 0, 0, 0};
+    constexpr int DY[6] = {0, 0, -1, 1, 0, 0};
+    constexpr int DZ[6] = {0, 0, 0, 0, -1, 1};
+    constexpr int DOWN = 2;
+
+    int channelLevel(uint8_t packed, int channel) {
+        return channel == SKY ? packed >> 4 : packed & 0x0F;
+    }
+
+    uint8_t withChannelLevel(uint8_t packed, int channel, int level) {
+        return channel == SKY ? static_cast<uint8_t>((packed & 0x0F) | (level << 4))
+                              : static_cast<uint8_t>((packed & 0xF0) | level);
+    }
+
+    // Full skylight travels straight down without fading, everything else loses one level per step
+    int spreadLevel(int channel, int direction, int level) {
+        if (channel == SKY && direction == DOWN && level == MAX_LIGHT) return MAX_LIGHT;
+        return level - 1;
+    }
+}
+
+LightEngine::LightEngine(World& world) : world(world) {
+}
+
+void LightEngine::computeChunkLight(const ChunkSnapshot& snapshot, std::span<uint8_t, CHUNK_VOLUME> light) {
+    std::fill(light.begin(), light.end(), 0);
+    std::vector<int> queue;
+
+    // Open sky above every column. Only sky voxels at or below the tallest column can
+    // spread sideways into anything darker, so only those seed the fill.
+    const int spreadTop = std::min(snapshot.maxSolidY + 1, CHUNK_HEIGHT - 1);
+    for (int z = 0; z < CHUNK_SIZE; z++) {
+        for (int x = 0; x < CHUNK_SIZE; x++) {
+            for (int y = snapshot.heightMap[z * CHUNK_SIZE + x]; y < CHUNK_HEIGHT; y++) {
+                const int i = Chunk::blockIndex(x, y, z);
+                light[i] = FULL_SKY_LIGHT;
+                if (y <= spreadTop) queue.push_back(i);
+            }
+        }
+    }
+
+    // Emitters can only be solid blocks, so they lie within the solid bounds
+    for (int y = std::max(snapshot.minSolidY, 0); y <= snapshot.maxSolidY; y++) {
+        for (int z = 0; z < CHUNK_SIZE; z++) {
+            for (int x = 0; x < CHUNK_SIZE; x++) {
+                const uint8_t emission = BlockRegistry::lightEmission(snapshot.getBlock(x, y, z).type);
+                if (emission == 0) continue;
+                const int i = Chunk::blockIndex(x, y, z);
+                light[i] = withChannelLevel(light[i], BLOCK, emission);
+                queue.push_back(i);
+            }
+        }
+    }
+
+    // Both channels spread together; a voxel is requeued whenever either one rises
+    for (size_t head = 0; head < queue.size(); head++) {
+        const int i = queue[head];
+        const int x = i % CHUNK_SIZE;
+        const int z = (i / CHUNK_SIZE) % CHUNK_SIZE;
+        const int y = i / CHUNK_AREA;
+
+        for (int d = 0; d < 6; d++) {
+            const int nx = x + DX[d], ny = y + DY[d], nz = z + DZ[d];
+            if (nx < 0 || nx >= CHUNK_SIZE || ny < 0 || ny >= CHUNK_HEIGHT || nz < 0 || nz >= CHUNK_SIZE) continue;
+            if (BlockRegistry::isOpaque(snapshot.getBlock(nx, ny, nz).type)) continue;
+
+            const int n = Chunk::blockIndex(nx, ny, nz);
+            uint8_t packed = light[n];
+            for (int channel = SKY; channel <= BLOCK; channel++) {
+                const int level = spreadLevel(channel, d, channelLevel(light[i], channel));
+                if (level > channelLevel(packed, channel)) packed = withChannelLevel(packed, channel, level);
+            }
+            if (packed != light[n]) {
+                light[n] = packed;
+                queue.push_back(n);
+            }
+        }
+    }
+}
+
+void LightEngine::onChunkLoaded(Chunk& chunk) {
+    std::array<uint8_t, CHUNK_VOLUME> light;
+    computeChunkLight(chunk.snapshot(), light);
+    onChunkLoaded(chunk, light);
+}
+
+void LightEngine::onChunkLoaded(Chunk& chunk, std::span<const uint8_t, CHUNK_VOLUME> light) {
+    const auto start = std::chrono::steady_clock::now();
+    cachedChunk = nullptr; // Chunks may have been unloaded since the last call
+    chunk.setLightData(light);
+
+    // Let light flow both ways across each border shared with a loaded neighbor.
+    // Above both chunks' solid bounds everything is open sky already.
+    const int baseX = chunk.position.x * CHUNK_SIZE;
+    const int baseZ = chunk.position.y * CHUNK_SIZE;
+    const int nx[4] = {-1, 1, 0, 0};
+    const int nz[4] = {0, 0, -1, 1};
+    for (int i = 0; i < 4; i++) {
+        const Chunk* neighbor = world.getChunk(chunk.position.x + nx[i], chunk.position.y + nz[i]);
+        if (!neighbor) continue;
+
+        const int top = std::min(std::max(chunk.getMaxSolidY(), neighbor->getMaxSolidY()) + 1, CHUNK_HEIGHT - 1);
+        for (int along = 0; along < CHUNK_SIZE; along++) {
+            for (int y = 0; y <= top; y++) {
+                // Inner voxel on this chunk's edge and the touching voxel just across it
+                int gx = baseX, gz = baseZ;
+                if (nx[i] != 0) {
+                    gx += nx[i] < 0 ? 0 : CHUNK_SIZE - 1;
+                    gz += along;
+                } else {
+                    gx += along;
+                    gz += nz[i] < 0 ? 0 : CHUNK_SIZE - 1;
+                }
+                addQueue.push_back({gx, y, gz, 0});
+                addQueue.push_back({gx + nx[i], y, gz + nz[i], 0});
+            }
+        }
+    }
+
+    // The same seeds serve both channels
+    const std::vector<Node> seeds = addQueue;
+    propagateAdd(SKY);
+    addQueue = seeds;
+    propagateAdd(BLOCK);
+
+    recordTiming(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+}
+
+void LightEngine::onBlockChanged(int gx, int gy, int gz) {
+    const auto start = std::chrono::steady_clock::now();
+    cachedChunk = nullptr; // Chunks may have been unloaded since the last call
+
+    VoxelRef ref;
+    if (!locate(gx, gy, gz, ref)) return;
+    const Block block = ref.chunk->getBlock(ref.x, ref.y, ref.z);
+
+    for (int channel = SKY; channel <= BLOCK; channel++) {
+        // Drop whatever light the voxel had and everything that depended on it;
+        // neighbors that still have light of their own end up in the add queue
+        const int oldLevel = channelLevel(ref.chunk->getLight(ref.x, ref.y, ref.z), channel);
+        setLevel(ref, channel, 0);
+        removeQueue.push_back({gx, gy, gz, static_cast<uint8_t>(oldLevel)});
+        propagateRemove(channel);
+
+        // Then add back the voxel's own sources
+        if (channel == BLOCK) {
+            const uint8_t emission = BlockRegistry::lightEmission(block.type);
+            if (emission > 0) {
+                setLevel(ref, channel, emission);
+                addQueue.push_back({gx, gy, gz, 0});
+            }
+        } else if (!BlockRegistry::isOpaque(block.type) && gy >= ref.chunk->getSurfaceHeight(ref.x, ref.z)) {
+            setLevel(ref, channel, MAX_LIGHT);
+            addQueue.push_back({gx, gy, gz, 0});
+        }
+        propagateAdd(channel);
+    }
+
+    recordTiming(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+}
+
+bool LightEngine::locate(int gx, int gy, int gz, VoxelRef& ref) {
+    if (gy < 0 || gy >= CHUNK_HEIGHT) return false;
+
+    const int cx = floorDiv(gx, CHUNK_SIZE);
+    const int cz = floorDiv(gz, CHUNK_SIZE);
+    if (!cachedChunk || cachedChunk->position.x != cx || cachedChunk->position.y != cz) {
+        cachedChunk = world.getChunk(cx, cz);
+        if (!cachedChunk) return false;
+    }
+
+    ref.chunk = cachedChunk;
+    ref.x = gx - cx * CHUNK_SIZE;
+    ref.y = gy;
+    ref.z = gz - cz * CHUNK_SIZE;
+    return true;
+}
+
+void LightEngine::setLevel(const VoxelRef& ref, int channel, int level) {
+    const uint8_t packed = ref.chunk->getLight(ref.x, ref.y, ref.z);
+    ref.chunk->setLight(ref.x, ref.y, ref.z, withChannelLevel(packed, channel, level));
+    world.markMeshDirty(*ref.chunk);
+
+    // Faces of the neighboring chunk sample this voxel too
+    const glm::ivec2& p = ref.chunk->position;
+    if (ref.x == 0) world.markMeshDirty(p.x - 1, p.y);
+    if (ref.x == CHUNK_SIZE - 1) world.markMeshDirty(p.x + 1, p.y);
+    if (ref.z == 0) world.markMeshDirty(p.x, p.y - 1);
+    if (ref.z == CHUNK_SIZE - 1) world.markMeshDirty(p.x, p.y + 1);
+}
+
+void LightEngine::propagateRemove(int channel) {
+    for (size_t head = 0; head < removeQueue.size(); head++) {
+        const Node node = removeQueue[head];
+        stats.nodesVisited++;
+
+        for (int d = 0; d < 6; d++) {
+            VoxelRef ref;
+            if (!locate(node.x + DX[d], node.y + DY[d], node.z + DZ[d], ref)) continue;
+
+            const int level = channelLevel(ref.chunk->getLight(ref.x, ref.y, ref.z), channel);
+            if (level == 0) continue;
+
+            if (level < node.level || level == spreadLevel(channel, d, node.level)) {
+                // This light came from the removed voxel; remove it too
+                setLevel(ref, channel, 0);
+                removeQueue.push_back({node.x + DX[d], node.y + DY[d], node.z + DZ[d], static_cast<uint8_t>(level)});
+            } else {
+                // Independent light bordering the hole; it refills it afterwards
+                addQueue.push_back({node.x + DX[d], node.y + DY[d], node.z + DZ[d], 0});
+            }
+        }
+    }
+    removeQueue.clear();
+}
+
+void LightEngine::propagateAdd(int channel) {
+    for (size_t head = 0; head < addQueue.size(); head++) {
+        const Node node = addQueue[head];
+        stats.nodesVisited++;
+
+        VoxelRef self;
+        if (!locate(node.x, node.y, node.z, self)) continue;
+        const int level = channelLevel(self.chunk->getLight(self.x, self.y, self.z), channel);
+        if (level <= 1) continue;
+
+        for (int d = 0; d < 6; d++) {
+            VoxelRef ref;
+            if (!locate(node.x + DX[d], node.y + DY[d], node.z + DZ[d], ref)) continue;
+            if (BlockRegistry::isOpaque(ref.chunk->getBlock(ref.x, ref.y, ref.z).type)) continue;
+
+            const int spread = spreadLevel(channel, d, level);
+            if (spread > channelLevel(ref.chunk->getLight(ref.x, ref.y, ref.z), channel)) {
+                setLevel(ref, channel, spread);
+                addQueue.push_back({node.x + DX[d], node.y + DY[d], node.z + DZ[d], 0});
+            }
+        }
+    }
+    addQueue.clear();
+}
+
+void LightEngine::recordTiming(double micros) {
+    stats.updates++;
+    stats.lastMicros = micros;
+    stats.maxMicros = std::max(stats.maxMicros, micros);
+    stats.totalMicros += micros;
+}
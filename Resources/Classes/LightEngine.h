@@ -0,0 +1,66 @@
+#pragma once
+#include "Chunk.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class World;
+
+struct LightStats {
+    uint64_t updates = 0;       // Chunk loads and block edits processed
+    uint64_t nodesVisited = 0;  // Voxels popped from the BFS queues, all time
+    double lastMicros = 0.0;
+    double maxMicros = 0.0;
+    double totalMicros = 0.0;
+
+    double averageMicros() const { return updates == 0 ? 0.0 : totalMicros / updates; }
+};
+
+// Queue-based flood fill for sky and block light.
+//
+// New chunks get their light in two steps: computeChunkLight works only on a snapshot,
+// so it can run on a worker thread, and onChunkLoaded applies the result and lets light
+// cross the borders to loaded neighbors. Block edits are handled incrementally: light
+// that depended on the changed voxel is removed by a BFS, then the surrounding light
+// refills the hole, so one edit only touches voxels within MAX_LIGHT of it.
+class LightEngine {
+public:
+    explicit LightEngine(World& world);
+
+    // Chunk-local light: open sky above each column, emitters, and propagation that
+    // stays inside the chunk. Reads only the snapshot; safe on any thread.
+    static void computeChunkLight(const ChunkSnapshot& snapshot, std::span<uint8_t, CHUNK_VOLUME> light);
+
+    // Apply precomputed light to a chunk that was just added to the world
+    void onChunkLoaded(Chunk& chunk, std::span<const uint8_t, CHUNK_VOLUME> light);
+    // Compute and apply in one go
+    void onChunkLoaded(Chunk& chunk);
+    // Call after the block at (gx, gy, gz) has changed
+    void onBlockChanged(int gx, int gy, int gz);
+
+    const LightStats& getStats() const { return stats; }
+
+private:
+    struct Node {
+        int x, y, z;
+        uint8_t level; // Only used by the removal queue
+    };
+
+    // One voxel resolved to its chunk; the last chunk is cached since BFS steps are local
+    struct VoxelRef {
+        Chunk* chunk;
+        int x, y, z;
+    };
+
+    World& world;
+    LightStats stats;
+    std::vector<Node> addQueue;
+    std::vector<Node> removeQueue;
+    Chunk* cachedChunk = nullptr;
+
+    bool locate(int gx, int gy, int gz, VoxelRef& ref);
+    void setLevel(const VoxelRef& ref, int channel, int level);
+    void propagateRemove(int channel);
+    void propagateAdd(int channel);
+    void recordTiming(double micros);
+};
@@ -0,0 +1,222 @@
+#include "RegionFile.h"
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    bool writeAll(int fd, const void* data, size_t size, uint64_t offset) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        while (size > 0) {
+            const ssize_t written = ::pwrite(fd, bytes, size, static_cast<off_t>(offset));
+            if (written <= 0) return false;
+            bytes += written;
+            size -= static_cast<size_t>(written);
+            offset += static_cast<uint64_t>(written);
+        }
+        return true;
+    }
+
+    bool readAll(int fd, void* data, size_t size, uint64_t offset) {
+        uint8_t* bytes = static_cast<uint8_t*>(data);
+        while (size > 0) {
+            const ssize_t got = ::pread(fd, bytes, size, static_cast<off_t>(offset));
+            if (got <= 0) return false;
+            bytes += got;
+            size -= static_cast<size_t>(got);
+            offset += static_cast<uint64_t>(got);
+        }
+        return true;
+    }
+
+    // Make a rename durable
+    void syncDirectory(const std::filesystem::path& directory) {
+        const int dirFd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+        if (dirFd < 0) return;
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+}
+
+RegionFile::~RegionFile() {
+    close();
+}
+
+bool RegionFile::open(const std::filesystem::path& path) {
+    close();
+    filePath = path;
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+
+    for (Entry& entry : table) entry = Entry{};
+    sequence = 0;
+    dataEnd = DATA_START;
+    dirty = false;
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        close();
+        return false;
+    }
+    const uint64_t fileBytes = static_cast<uint64_t>(info.st_size);
+
+    // A header is only trusted if everything it points at is inside the file
+    auto header = std::make_unique<Header>();
+    bool found = false;
+    for (int slot = 0; slot < 2; slot++) {
+        if (!readHeader(slot, *header) || header->dataEnd > fileBytes) continue;
+        if (found && header->sequence <= sequence) continue;
+        found = true;
+        sequence = header->sequence;
+        dataEnd = header->dataEnd;
+        std::memcpy(table, header->entries, sizeof(table));
+    }
+
+    // New or unreadable: start empty. Header slots read back as zeros until first commit.
+    if (fileBytes < DATA_START && ::ftruncate(fd, static_cast<off_t>(DATA_START)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void RegionFile::close() {
+    unmapFile();
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+bool RegionFile::read(int index, std::vector<uint8_t>& data) {
+    const Entry& entry = table[index];
+    if (entry.length == 0) return false;
+    // Payloads appended since the file was mapped are past the end of the mapping
+    if (entry.offset + entry.length > mappedBytes && !mapFile()) return false;
+    if (entry.offset + entry.length > mappedBytes) return false;
+
+    const uint8_t* payload = mapped + entry.offset;
+    if (checksumOf(payload, entry.length) != entry.checksum) return false;
+    data.assign(payload, payload + entry.length);
+    return true;
+}
+
+bool RegionFile::write(int index, std::span<const uint8_t> data) {
+    if (fd < 0 || data.empty()) return false;
+    if (!writeAll(fd, data.data(), data.size(), dataEnd)) return false;
+
+    table[index] = Entry{dataEnd, static_cast<uint32_t>(data.size()), checksumOf(data.data(), data.size())};
+    dataEnd += data.size();
+    dirty = true;
+    return true;
+}
+
+bool RegionFile::commit() {
+    if (!dirty) return true;
+    // Payloads must be on disk before any header that points at them
+    if (::fsync(fd) != 0) return false;
+    sequence++;
+    if (!writeHeader(static_cast<int>(sequence % 2)) || ::fsync(fd) != 0) return false;
+    dirty = false;
+    return true;
+}
+
+uint64_t RegionFile::liveBytes() const {
+    uint64_t bytes = 0;
+    for (const Entry& entry : table) bytes += entry.length;
+    return bytes;
+}
+
+uint64_t RegionFile::garbageBytes() const {
+    return dataEnd - DATA_START - liveBytes();
+}
+
+bool RegionFile::writeCompacted(std::filesystem::path& tempPath) {
+    if (!commit()) return false;
+
+    tempPath = filePath.string() + ".tmp";
+    const int tempFd = ::open(tempPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (tempFd < 0) return false;
+
+    // Live payloads are packed in table order behind fresh, zeroed header slots. They are
+    // read with pread rather than read(), which may remap the file under a concurrent read().
+    RegionFile packed;
+    packed.fd = tempFd;
+    packed.filePath = tempPath;
+    bool ok = ::ftruncate(tempFd, static_cast<off_t>(DATA_START)) == 0;
+    std::vector<uint8_t> payload;
+    for (int index = 0; ok && index < REGION_AREA; index++) {
+        const Entry& entry = table[index];
+        if (entry.length == 0) continue;
+        payload.resize(entry.length);
+        ok = readAll(fd, payload.data(), entry.length, entry.offset) &&
+             checksumOf(payload.data(), entry.length) == entry.checksum && packed.write(index, payload);
+    }
+    ok = ok && packed.commit();
+    packed.close();
+
+    if (!ok) std::filesystem::remove(tempPath);
+    return ok;
+}
+
+bool RegionFile::replaceWithCompacted(const std::filesystem::path& tempPath) {
+    if (std::rename(tempPath.c_str(), filePath.c_str()) != 0) {
+        std::filesystem::remove(tempPath);
+        return false;
+    }
+    syncDirectory(filePath.parent_path());
+    return open(filePath);
+}
+
+uint32_t RegionFile::checksumOf(const uint8_t* data, size_t size) {
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t RegionFile::headerChecksum(const Header& header) {
+    return checksumOf(reinterpret_cast<const uint8_t*>(&header), offsetof(Header, checksum));
+}
+
+bool RegionFile::readHeader(int slot, Header& header) const {
+    if (!readAll(fd, &header, sizeof(Header), slot * SLOT_BYTES)) return false;
+    return header.magic == MAGIC && header.version == VERSION && header.checksum == headerChecksum(header) &&
+           header.dataEnd >= DATA_START;
+}
+
+bool RegionFile::writeHeader(int slot) {
+    auto header = std::make_unique<Header>(); // Value-initialized, padding included
+    header->magic = MAGIC;
+    header->version = VERSION;
+    header->sequence = sequence;
+    header->dataEnd = dataEnd;
+    std::memcpy(header->entries, table, sizeof(table));
+    header->checksum = headerChecksum(*header);
+    return writeAll(fd, header.get(), sizeof(Header), slot * SLOT_BYTES);
+}
+
+bool RegionFile::mapFile() {
+    unmapFile();
+    struct stat info;
+    if (fd < 0 || ::fstat(fd, &info) != 0 || info.st_size <= 0) return false;
+
+    void* address = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) return false;
+    mapped = static_cast<const uint8_t*>(address);
+    mappedBytes = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void RegionFile::unmapFile() {
+    if (mapped) {
+        ::munmap(const_cast<uint8_t*>(mapped), mappedBytes);
+        mapped = nullptr;
+        mappedBytes = 0;
+    }
+}
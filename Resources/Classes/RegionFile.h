@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+// One file holding a payload for each of up to REGION_CHUNKS x REGION_CHUNKS chunks.
+//
+// Layout: two header slots (A and B) followed by chunk payloads. Each header holds a
+// sequence number, the end of the used data and an offset table with one entry per
+// chunk, and is covered by a checksum. Payloads are only ever appended; rewriting a
+// chunk appends a new copy and leaves the old one as garbage until compaction.
+//
+// commit() syncs the appended data and only then writes the table into the slot not
+// holding the current header, so a crash at any point leaves at least one complete
+// header describing data that is fully on disk. open() takes the valid header with the
+// highest sequence number. Reads go through a read-only memory map of the file.
+//
+// Not thread-safe; RegionStore serializes access. The exception is that commit() and
+// writeCompacted() only read the table, so read() may run alongside them as long as
+// nothing else writes to or reopens the file meanwhile.
+class RegionFile {
+public:
+    static constexpr int REGION_CHUNKS = 32;
+    static constexpr int REGION_AREA = REGION_CHUNKS * REGION_CHUNKS;
+
+    RegionFile() = default;
+    ~RegionFile();
+
+    RegionFile(const RegionFile&) = delete;
+    RegionFile& operator=(const RegionFile&) = delete;
+
+    // Open or create the file. Returns false if it cannot be opened for writing.
+    bool open(const std::filesystem::path& path);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    // Slot of a chunk inside its region, for chunk coordinates taken mod REGION_CHUNKS
+    static int chunkIndex(int localX, int localZ) { return localZ * REGION_CHUNKS + localX; }
+
+    bool contains(int index) const { return table[index].length != 0; }
+    // Copy a chunk's payload into data. False if absent or if its checksum does not match.
+    bool read(int index, std::vector<uint8_t>& data);
+    // Append a new payload for the chunk. Not durable until commit().
+    bool write(int index, std::span<const uint8_t> data);
+    // Make all writes so far durable
+    bool commit();
+    bool hasUncommittedWrites() const { return dirty; }
+
+    // Bytes held by payloads that are no longer referenced by the table
+    uint64_t garbageBytes() const;
+    uint64_t liveBytes() const;
+    // Compaction rewrites the file with only the live payloads, in two steps so the slow
+    // one can run alongside reads. writeCompacted() commits pending writes and copies the
+    // live payloads into a temporary file; replaceWithCompacted() renames it over this
+    // file and reopens it.
+    bool writeCompacted(std::filesystem::path& tempPath);
+    bool replaceWithCompacted(const std::filesystem::path& tempPath);
+
+private:
+    struct Entry {
+        uint64_t offset = 0;
+        uint32_t length = 0;
+        uint32_t checksum = 0;
+    };
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sequence;
+        uint64_t dataEnd;
+        Entry entries[REGION_AREA];
+        uint32_t checksum; // Over everything above
+    };
+
+    static constexpr uint32_t MAGIC = 0x47525856; // "VXRG"
+    static constexpr uint32_t VERSION = 1;
+    // Header slots are padded to whole pages so payload writes never touch them
+    static constexpr uint64_t SLOT_BYTES = (sizeof(Header) + 4095) / 4096 * 4096;
+    static constexpr uint64_t DATA_START = 2 * SLOT_BYTES;
+
+    std::filesystem::path filePath;
+    int fd = -1;
+    Entry table[REGION_AREA];
+    uint64_t sequence = 0;
+    uint64_t dataEnd = DATA_START;
+    bool dirty = false;
+
+    const uint8_t* mapped = nullptr;
+    size_t mappedBytes = 0;
+
+    static uint32_t checksumOf(const uint8_t* data, size_t size);
+    static uint32_t headerChecksum(const Header& header);
+    bool readHeader(int slot, Header& header) const;
+    bool writeHeader(int slot);
+    bool mapFile();
+    void unmapFile();
+};
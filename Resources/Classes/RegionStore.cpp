@@ -0,0 +1,124 @@
+#include "RegionStore.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+namespace {
+    // Chunk coordinates to region coordinates and the slot inside the region
+    constexpr int REGION_SHIFT = 5;
+    static_assert(RegionFile::REGION_CHUNKS == 1 << REGION_SHIFT, "REGION_SHIFT must match REGION_CHUNKS");
+    constexpr int REGION_MASK = RegionFile::REGION_CHUNKS - 1;
+}
+
+RegionStore::RegionStore(std::filesystem::path directory) : directory(std::move(directory)) {
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+    if (error) {
+        std::cerr << "Cannot create save directory " << this->directory << ": " << error.message() << std::endl;
+    }
+}
+
+RegionStore::~RegionStore() {
+    flush();
+}
+
+int64_t RegionStore::keyFor(int x, int z) {
+    return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(z);
+}
+
+std::filesystem::path RegionStore::regionPath(int regionX, int regionZ) const {
+    return directory / ("r." + std::to_string(regionX) + "." + std::to_string(regionZ) + ".vxr");
+}
+
+RegionFile* RegionStore::region(int regionX, int regionZ, bool create) {
+    auto it = regions.find(keyFor(regionX, regionZ));
+    if (it != regions.end() && (it->second || !create)) return it->second.get();
+
+    const std::filesystem::path path = regionPath(regionX, regionZ);
+    std::unique_ptr<RegionFile> file;
+    if (create || std::filesystem::exists(path)) {
+        file = std::make_unique<RegionFile>();
+        if (!file->open(path)) {
+            std::cerr << "Cannot open region file " << path << std::endl;
+            file.reset();
+        }
+    }
+    RegionFile* result = file.get();
+    regions[keyFor(regionX, regionZ)] = std::move(file);
+    return result;
+}
+
+void RegionStore::save(const glm::ivec2& position, std::vector<uint8_t> data) {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    pending[keyFor(position.x, position.y)] = Pending{position, std::move(data), ++nextVersion};
+}
+
+bool RegionStore::load(const glm::ivec2& position, std::vector<uint8_t>& data) {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        auto it = pending.find(keyFor(position.x, position.y));
+        if (it != pending.end()) {
+            data = it->second.data;
+            return true;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(fileMutex);
+    RegionFile* file = region(position.x >> REGION_SHIFT, position.y >> REGION_SHIFT, false);
+    return file && file->read(RegionFile::chunkIndex(position.x & REGION_MASK, position.y & REGION_MASK), data);
+}
+
+void RegionStore::flush() {
+    std::lock_guard<std::mutex> flushLock(flushMutex);
+
+    std::vector<Pending> batch;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        batch.reserve(pending.size());
+        for (const auto& [key, entry] : pending) batch.push_back(entry);
+    }
+    if (batch.empty()) return;
+
+    RegionStats written;
+    std::vector<RegionFile*> touched;
+    {
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        for (const Pending& entry : batch) {
+            RegionFile* file = region(entry.position.x >> REGION_SHIFT, entry.position.y >> REGION_SHIFT, true);
+            if (!file) continue;
+            const int index = RegionFile::chunkIndex(entry.position.x & REGION_MASK, entry.position.y & REGION_MASK);
+            if (!file->write(index, entry.data)) continue;
+            written.chunksWritten++;
+            written.bytesWritten += entry.data.size();
+            if (std::find(touched.begin(), touched.end(), file) == touched.end()) touched.push_back(file);
+        }
+    }
+
+    // Loads keep going while the files sync and compact. The chunks in the batch are
+    // still served from pending, and nothing else changes until a compacted file is swapped in.
+    for (RegionFile* file : touched) {
+        if (!file->commit()) std::cerr << "Failed to commit region file" << std::endl;
+        const uint64_t garbage = file->garbageBytes();
+        if (garbage < COMPACT_MIN_GARBAGE || garbage <= file->liveBytes()) continue;
+        std::filesystem::path compactedPath;
+        if (!file->writeCompacted(compactedPath)) continue;
+        std::lock_guard<std::mutex> fileLock(fileMutex);
+        if (file->replaceWithCompacted(compactedPath)) written.compactions++;
+    }
+
+    // Only now can loads go to disk for these chunks. Entries saved again while this
+    // flush ran keep their newer data and go out with the next one.
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    stats.chunksWritten += written.chunksWritten;
+    stats.bytesWritten += written.bytesWritten;
+    stats.compactions += written.compactions;
+    for (const Pending& entry : batch) {
+        auto it = pending.find(keyFor(entry.position.x, entry.position.y));
+        if (it != pending.end() && it->second.version == entry.version) pending.erase(it);
+    }
+}
+
+RegionStats RegionStore::getStats() const {
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    return stats;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "RegionFile.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct RegionStats {
+    uint64_t chunksWritten = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t compactions = 0;
+};
+
+// One record per chunk saved to a directory of region files (see RegionFile), one file
+// per 32 x 32 chunks; EditJournal keeps its compacted delta lists here. save() only
+// queues the data in memory; flush() writes everything queued, commits it and compacts
+// files that are mostly garbage. Records queued but not yet flushed are served from
+// memory, so a chunk can be loaded again right after it was saved. All methods may be
+// called from any thread.
+class RegionStore {
+public:
+    explicit RegionStore(std::filesystem::path directory);
+    // Flushes whatever is still queued
+    ~RegionStore();
+
+    RegionStore(const RegionStore&) = delete;
+    RegionStore& operator=(const RegionStore&) = delete;
+
+    // Queue the chunk's record for writing, replacing any earlier one
+    void save(const glm::ivec2& position, std::vector<uint8_t> data);
+    // Latest saved data for the chunk, false if it was never saved
+    bool load(const glm::ivec2& position, std::vector<uint8_t>& data);
+    void flush();
+
+    RegionStats getStats() const;
+
+private:
+    struct Pending {
+        glm::ivec2 position;
+        std::vector<uint8_t> data;
+        uint64_t version; // Lets flush() tell whether the entry was replaced meanwhile
+    };
+
+    std::filesystem::path directory;
+
+    // Lock order: flushMutex, fileMutex, pendingMutex. flushMutex keeps one flush at a
+    // time, so only the flush changes the files. It holds fileMutex while it appends and
+    // swaps in compacted files, but not across fsync or compaction: those only read the
+    // tables, which loads may do too. pendingMutex is never held across I/O.
+    std::mutex flushMutex;
+    mutable std::mutex pendingMutex;
+    std::unordered_map<int64_t, Pending> pending;
+    uint64_t nextVersion = 0;
+    RegionStats stats;
+
+    mutable std::mutex fileMutex;
+    // Open files by region key; nullptr once a region is known to have no file
+    std::unordered_map<int64_t, std::unique_ptr<RegionFile>> regions;
+
+    // Compact once garbage is this large and outweighs the live data
+    static constexpr uint64_t COMPACT_MIN_GARBAGE = 1024 * 1024;
+
+    static int64_t keyFor(int x, int z);
+    std::filesystem::path regionPath(int regionX, int regionZ) const;
+    // Open file for the region; with create == false, nullptr if it does not exist
+    RegionFile* region(int regionX, int regionZ, bool create);
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads draining one FIFO job queue. With zero threads every job
+// runs inline inside submit(), which gives a fully synchronous build of the same code.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threadCount);
+    // Jobs still queued are dropped; running ones finish first
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> job);
+    // Block until the queue is empty and no job is running
+    void waitIdle();
+
+    unsigned threadCount() const { return static_cast<unsigned>(threads.size()); }
+    size_t queuedCount() const;
+
+    // One thread per core, leaving one for the render thread
+    static unsigned defaultThreadCount();
+
+private:
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> queue;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    size_t running = 0;
+    bool stopping = false;
+
+    void workerLoop();
+};
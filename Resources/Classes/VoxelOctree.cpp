@@ -0,0 +1,335 @@
+#include "VoxelOctree.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+static_assert(SECTION_HEIGHT == CHUNK_SIZE, "Octree inserts sections as cubes");
+
+namespace {
+    constexpr int SECTION_LEVEL = 4; // log2(CHUNK_SIZE)
+    static_assert((1 << SECTION_LEVEL) == CHUNK_SIZE, "SECTION_LEVEL must match CHUNK_SIZE");
+
+    constexpr uint32_t FILE_MAGIC = 0x4F585653; // "SVXO"
+
+    // Child octant for a coordinate local to a node of the given level
+    int childIndex(const glm::ivec3& local, int level) {
+        const int half = level - 1;
+        return ((local.x >> half) & 1) | (((local.y >> half) & 1) << 1) | (((local.z >> half) & 1) << 2);
+    }
+
+    glm::ivec3 childOffset(int child, int level) {
+        const int half = 1 << (level - 1);
+        return glm::ivec3((child & 1) * half, ((child >> 1) & 1) * half, ((child >> 2) & 1) * half);
+    }
+}
+
+size_t VoxelOctree::NodeHash::operator()(const Node& node) const {
+    size_t h = 1469598103934665603ull;
+    for (uint32_t ref : node) {
+        h = (h ^ ref) * 1099511628211ull;
+    }
+    return h;
+}
+
+VoxelOctree::VoxelOctree(int depth)
+    : initialDepth(std::clamp(depth, SECTION_LEVEL, MAX_DEPTH)), depth(initialDepth), root(leaf(BlockType::AIR)) {
+}
+
+void VoxelOctree::clear() {
+    depth = initialDepth;
+    root = leaf(BlockType::AIR);
+    nodes.clear();
+    internTable.clear();
+    compactedNodeCount = 0;
+}
+
+uint32_t VoxelOctree::intern(const Node& node) {
+    // Eight identical leaves are just a bigger leaf
+    if (isLeaf(node[0]) && std::all_of(node.begin(), node.end(), [&](uint32_t ref) { return ref == node[0]; })) {
+        return node[0];
+    }
+
+    auto it = internTable.find(node);
+    if (it != internTable.end()) return it->second;
+
+    const uint32_t index = static_cast<uint32_t>(nodes.size());
+    nodes.push_back(node);
+    internTable.emplace(node, index);
+    return index;
+}
+
+uint32_t VoxelOctree::buildSection(const ChunkSection& section, int x0, int y0, int z0, int level) {
+    Node node;
+    for (int child = 0; child < 8; child++) {
+        const glm::ivec3 offset = childOffset(child, level);
+        if (level == 1) {
+            const Block block = section.blocks[Chunk::blockIndex(x0 + offset.x, y0 + offset.y, z0 + offset.z)];
+            node[child] = leaf(block.type);
+        } else {
+            node[child] = buildSection(section, x0 + offset.x, y0 + offset.y, z0 + offset.z, level - 1);
+        }
+    }
+    return intern(node);
+}
+
+uint32_t VoxelOctree::replaceSubtree(uint32_t ref, int level, const glm::ivec3& local, int targetLevel, uint32_t subtree) {
+    if (level == targetLevel) return subtree;
+
+    // Leaves are expanded into eight copies of themselves on the way down
+    Node node;
+    if (isLeaf(ref)) node.fill(ref);
+    else node = nodes[ref];
+
+    const int child = childIndex(local, level);
+    node[child] = replaceSubtree(node[child], level - 1, local, targetLevel, subtree);
+    return intern(node);
+}
+
+void VoxelOctree::grow() {
+    // In units of the old root's octants, the new root spans 4 x 4 x 4 and the old tree
+    // sits at x and z in [1, 3), y in [0, 2). Each old octant becomes the grandchild of
+    // the new root that covers the same blocks.
+    Node octants;
+    if (isLeaf(root)) octants.fill(root);
+    else octants = nodes[root];
+
+    std::array<Node, 8> children;
+    for (Node& child : children) child.fill(leaf(BlockType::AIR));
+    for (int octant = 0; octant < 8; octant++) {
+        const int x = 1 + (octant & 1);
+        const int y = (octant >> 1) & 1;
+        const int z = 1 + ((octant >> 2) & 1);
+        children[(x >> 1) | ((y >> 1) << 1) | ((z >> 1) << 2)][(x & 1) | ((y & 1) << 1) | ((z & 1) << 2)] = octants[octant];
+    }
+
+    Node top;
+    for (int child = 0; child < 8; child++) top[child] = intern(children[child]);
+    root = intern(top);
+    depth++;
+}
+
+void VoxelOctree::insertChunk(const ChunkSnapshot& chunk) {
+    const glm::ivec3 global(chunk.position.x * CHUNK_SIZE, 0, chunk.position.y * CHUNK_SIZE);
+    glm::ivec3 base = global - origin();
+    while ((base.x < 0 || base.z < 0 || base.x >= size() || base.z >= size()) && depth < MAX_DEPTH) {
+        grow();
+        base = global - origin();
+    }
+    if (base.x < 0 || base.z < 0 || base.x >= size() || base.z >= size()) {
+        rejected++;
+        return;
+    }
+
+    for (int s = 0; s < CHUNK_SECTIONS; s++) {
+        const glm::ivec3 local(base.x, s * SECTION_HEIGHT, base.z);
+        if (local.y >= size()) break;
+        const uint32_t subtree = buildSection(chunk.section(s), 0, 0, 0, SECTION_LEVEL);
+        root = replaceSubtree(root, depth, local, SECTION_LEVEL, subtree);
+    }
+
+    // Every insert leaves the old path behind; reclaim once garbage dominates
+    if (nodes.size() > 2 * compactedNodeCount + 4096) {
+        compact();
+    }
+}
+
+BlockType VoxelOctree::getBlock(int gx, int gy, int gz) const {
+    const glm::ivec3 local = glm::ivec3(gx, gy, gz) - origin();
+    if (local.x < 0 || local.y < 0 || local.z < 0 || local.x >= size() || local.y >= size() || local.z >= size())
+        return BlockType::AIR;
+
+    uint32_t ref = root;
+    for (int level = depth; !isLeaf(ref); level--) {
+        ref = nodes[ref][childIndex(local, level)];
+    }
+    return leafType(ref);
+}
+
+bool VoxelOctree::anySolid(const glm::ivec3& min, const glm::ivec3& max) const {
+    const glm::ivec3 lo = glm::max(min - origin(), glm::ivec3(0));
+    const glm::ivec3 hi = glm::min(max - origin(), glm::ivec3(size()));
+    if (lo.x >= hi.x || lo.y >= hi.y || lo.z >= hi.z) return false;
+    return anySolid(root, depth, glm::ivec3(0), lo, hi);
+}
+
+bool VoxelOctree::anySolid(uint32_t ref, int level, const glm::ivec3& nodeMin,
+                           const glm::ivec3& min, const glm::ivec3& max) const {
+    if (isLeaf(ref)) return BlockRegistry::isSolid(leafType(ref));
+
+    for (int child = 0; child < 8; child++) {
+        const glm::ivec3 childMin = nodeMin + childOffset(child, level);
+        const int childSize = 1 << (level - 1);
+        if (childMin.x >= max.x || childMin.y >= max.y || childMin.z >= max.z ||
+            childMin.x + childSize <= min.x || childMin.y + childSize <= min.y || childMin.z + childSize <= min.z)
+            continue;
+        if (anySolid(nodes[ref][child], level - 1, childMin, min, max)) return true;
+    }
+    return false;
+}
+
+bool VoxelOctree::raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, OctreeHit& hit) const {
+    const float len = glm::length(dir);
+    if (len == 0.0f) return false;
+
+    // Work in tree-local coordinates so node bounds are plain [min, min + size)
+    Ray ray;
+    ray.origin = origin - glm::vec3(this->origin());
+    ray.dir = dir / len;
+    const float inf = std::numeric_limits<float>::infinity();
+    ray.invDir = glm::vec3(ray.dir.x != 0.0f ? 1.0f / ray.dir.x : inf,
+                           ray.dir.y != 0.0f ? 1.0f / ray.dir.y : inf,
+                           ray.dir.z != 0.0f ? 1.0f / ray.dir.z : inf);
+
+    if (!raycast(root, depth, glm::ivec3(0), ray, 0.0f, maxDist, hit)) return false;
+    hit.block += this->origin();
+    return true;
+}
+
+bool VoxelOctree::raycast(uint32_t ref, int level, const glm::ivec3& nodeMin, const Ray& ray,
+                          float tMin, float tMax, OctreeHit& hit) const {
+    const glm::vec3& origin = ray.origin;
+    const glm::vec3& invDir = ray.invDir;
+
+    // Slab test against this node's box, remembering which axis we entered through
+    const float nodeSize = static_cast<float>(1 << level);
+    float tNear = -std::numeric_limits<float>::infinity();
+    float tExit = tMax;
+    int enterAxis = -1;
+    for (int axis = 0; axis < 3; axis++) {
+        float t0 = (static_cast<float>(nodeMin[axis]) - origin[axis]) * invDir[axis];
+        float t1 = (static_cast<float>(nodeMin[axis]) + nodeSize - origin[axis]) * invDir[axis];
+        if (std::isnan(t0) || std::isnan(t1)) {
+            // Ray parallel to and exactly on a slab plane; treat as inside if within
+            if (origin[axis] < nodeMin[axis] || origin[axis] >= nodeMin[axis] + nodeSize) return false;
+            continue;
+        }
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 > tNear) { tNear = t0; enterAxis = axis; }
+        tExit = std::min(tExit, t1);
+    }
+    // Starting inside the box means there is no entry face
+    if (tNear <= 0.0f) enterAxis = -1;
+    const float tEnter = std::max(tMin, tNear);
+    if (tEnter > tExit) return false;
+
+    if (isLeaf(ref)) {
+        const BlockType type = leafType(ref);
+        if (!BlockRegistry::isSolid(type)) return false;
+
+        // A solid leaf may cover many voxels; report the voxel at the entry point
+        const glm::vec3 entry = ray.origin + ray.dir * tEnter;
+        glm::ivec3 block(glm::floor(entry));
+        glm::ivec3 normal(0);
+        if (enterAxis >= 0) {
+            const bool positive = invDir[enterAxis] > 0.0f;
+            normal[enterAxis] = positive ? -1 : 1;
+            // Entered through this leaf's own face: the block is the layer behind that
+            // face, whatever rounding did to the entry point
+            if (tNear >= tMin) {
+                block[enterAxis] = positive ? nodeMin[enterAxis] : nodeMin[enterAxis] + static_cast<int>(nodeSize) - 1;
+            }
+        }
+        block = glm::clamp(block, nodeMin, nodeMin + glm::ivec3(static_cast<int>(nodeSize) - 1));
+
+        hit.block = block;
+        hit.normal = normal;
+        hit.distance = tEnter;
+        hit.type = type;
+        return true;
+    }
+
+    // Visit children front to back by their entry distance
+    struct Candidate { float t; int child; };
+    Candidate order[8];
+    const int childSize = 1 << (level - 1);
+    for (int child = 0; child < 8; child++) {
+        const glm::ivec3 childMin = nodeMin + childOffset(child, level);
+        float t = tEnter;
+        for (int axis = 0; axis < 3; axis++) {
+            if (std::isinf(invDir[axis])) continue;
+            const float slab = invDir[axis] > 0.0f ? static_cast<float>(childMin[axis])
+                                                   : static_cast<float>(childMin[axis] + childSize);
+            t = std::max(t, (slab - origin[axis]) * invDir[axis]);
+        }
+        order[child] = {t, child};
+    }
+    std::sort(order, order + 8, [](const Candidate& a, const Candidate& b) { return a.t < b.t; });
+
+    for (const Candidate& c : order) {
+        if (c.t > tExit) break;
+        const glm::ivec3 childMin = nodeMin + childOffset(c.child, level);
+        if (raycast(nodes[ref][c.child], level - 1, childMin, ray, tEnter, tExit, hit)) return true;
+    }
+    return false;
+}
+
+std::vector<uint32_t> VoxelOctree::reachableNodes(std::vector<uint32_t>& remap) const {
+    // Post-order so children always get smaller indices than their parents
+    std::vector<uint32_t> order;
+    remap.assign(nodes.size(), UINT32_MAX);
+    if (isLeaf(root)) return order;
+
+    std::vector<std::pair<uint32_t, int>> stack{{root, 0}};
+    while (!stack.empty()) {
+        auto& [index, next] = stack.back();
+        if (next < 8) {
+            const uint32_t child = nodes[index][next++];
+            if (!isLeaf(child) && remap[child] == UINT32_MAX) {
+                remap[child] = UINT32_MAX - 1; // Mark as in progress
+                stack.push_back({child, 0});
+            }
+        } else {
+            remap[index] = static_cast<uint32_t>(order.size());
+            order.push_back(index);
+            stack.pop_back();
+        }
+    }
+    return order;
+}
+
+void VoxelOctree::compact() {
+    std::vector<uint32_t> remap;
+    const std::vector<uint32_t> order = reachableNodes(remap);
+
+    std::vector<Node> compacted;
+    compacted.reserve(order.size());
+    internTable.clear();
+    for (uint32_t index : order) {
+        Node node = nodes[index];
+        for (uint32_t& ref : node) {
+            if (!isLeaf(ref)) ref = remap[ref];
+        }
+        internTable.emplace(node, static_cast<uint32_t>(compacted.size()));
+        compacted.push_back(node);
+    }
+    if (!isLeaf(root)) root = remap[root];
+    nodes = std::move(compacted);
+    compactedNodeCount = nodes.size();
+}
+
+size_t VoxelOctree::serializedSize() const {
+    std::vector<uint32_t> remap;
+    const size_t reachable = reachableNodes(remap).size();
+    // magic, depth, root, node count, then the nodes
+    return 4 * sizeof(uint32_t) + reachable * sizeof(Node);
+}
+
+void VoxelOctree::write(std::ostream& out) const {
+    std::vector<uint32_t> remap;
+    const std::vector<uint32_t> order = reachableNodes(remap);
+
+    const uint32_t header[4] = {
+        FILE_MAGIC,
+        static_cast<uint32_t>(depth),
+        isLeaf(root) ? root : remap[root],
+        static_cast<uint32_t>(order.size()),
+    };
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (uint32_t index : order) {
+        Node node = nodes[index];
+        for (uint32_t& ref : node) {
+            if (!isLeaf(ref)) ref = remap[ref];
+        }
+        out.write(reinterpret_cast<const char*>(node.data()), sizeof(Node));
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "Chunk.h"
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+struct OctreeHit {
+    glm::ivec3 block;
+    glm::ivec3 normal; // Face of the block the ray entered through
+    float distance;
+    BlockType type;
+};
+
+// Sparse voxel octree with identical subtrees shared (an SVO-DAG), used as compact
+// far-field storage for chunks outside the streaming radius. Uniform regions collapse
+// into a single leaf and repeated patterns (flat stone layers, air) are stored once.
+//
+// The tree covers x and z in [-size/2, size/2) and y in [0, size), size = 2^depth.
+// Inserting a chunk outside adds levels above the root, doubling the size each time, up
+// to MAX_DEPTH (chunk coordinates within +-2^25). Chunks beyond that are dropped and
+// counted in rejectedChunks().
+// Nodes are immutable once created; inserting a chunk builds new nodes along the
+// path to the root and leaves the replaced ones for compact() to reclaim.
+class VoxelOctree {
+public:
+    static constexpr int MAX_DEPTH = 30;
+
+    explicit VoxelOctree(int depth = 12);
+
+    // Replace the region covered by the chunk with its contents, growing the tree first
+    // if the chunk lies outside it
+    void insertChunk(const ChunkSnapshot& chunk);
+    // Back to the initial depth, all air
+    void clear();
+
+    BlockType getBlock(int gx, int gy, int gz) const;
+    // True if any solid block lies in the half-open box [min, max)
+    bool anySolid(const glm::ivec3& min, const glm::ivec3& max) const;
+    // First solid block along the ray within maxDist; dir does not need to be normalized
+    bool raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, OctreeHit& hit) const;
+
+    int size() const { return 1 << depth; }
+    int getDepth() const { return depth; }
+    size_t nodeCount() const { return nodes.size(); }
+    // Chunks insertChunk dropped for lying beyond MAX_DEPTH
+    uint64_t rejectedChunks() const { return rejected; }
+    // Bytes write() produces: header plus every node reachable from the root
+    size_t serializedSize() const;
+    void write(std::ostream& out) const;
+    // Drop nodes no longer reachable from the root
+    void compact();
+
+private:
+    using Node = std::array<uint32_t, 8>;
+
+    // A child reference is either a node index or, with LEAF_BIT set, a uniform
+    // block type filling the whole child cube
+    static constexpr uint32_t LEAF_BIT = 0x80000000u;
+    static constexpr uint32_t leaf(BlockType type) { return LEAF_BIT | static_cast<uint8_t>(type); }
+    static constexpr bool isLeaf(uint32_t ref) { return (ref & LEAF_BIT) != 0; }
+    static constexpr BlockType leafType(uint32_t ref) { return static_cast<BlockType>(ref & 0xFF); }
+
+    struct Ray {
+        glm::vec3 origin; // Tree-local
+        glm::vec3 dir;    // Normalized
+        glm::vec3 invDir;
+    };
+
+    struct NodeHash {
+        size_t operator()(const Node& node) const;
+    };
+
+    int initialDepth;
+    int depth;
+    uint32_t root;
+    uint64_t rejected = 0;
+    std::vector<Node> nodes;
+    std::unordered_map<Node, uint32_t, NodeHash> internTable;
+    size_t compactedNodeCount = 0;
+
+    glm::ivec3 origin() const { return glm::ivec3(-size() / 2, 0, -size() / 2); }
+
+    uint32_t intern(const Node& node);
+    // Add a level above the root, keeping the current tree in the middle
+    void grow();
+    uint32_t buildSection(const ChunkSection& section, int x0, int y0, int z0, int level);
+    uint32_t replaceSubtree(uint32_t ref, int level, const glm::ivec3& local, int targetLevel, uint32_t subtree);
+    bool anySolid(uint32_t ref, int level, const glm::ivec3& nodeMin, const glm::ivec3& min, const glm::ivec3& max) const;
+    bool raycast(uint32_t ref, int level, const glm::ivec3& nodeMin, const Ray& ray,
+                 float tMin, float tMax, OctreeHit& hit) const;
+    std::vector<uint32_t> reachableNodes(std::vector<uint32_t>& remap) const;
+};
@@ -1,107 +1,1159 @@
 #include "World.h"
+#include "ChunkCompression.h"
+#include "ChunkMesher.h"
 #include "WorldGeneration.h"
 #include <algorithm>
 #include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <vector>
 
-World::World() : renderDistance(8) {
-    // Initialize with empty world
+static float microsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+World::World(unsigned workerThreads, const std::filesystem::path& saveDirectory)
+    : renderDistance(8), loadDistance(renderDistance + 1), unloadDistance(loadDistance + UNLOAD_MARGIN), chunks(unloadDistance), coldDistance(16), coldCache(32 * 1024 * 1024), lightEngine(*this),
+      workers(workerThreads) {
+    BlockRegistry::seal();
+    if (!saveDirectory.empty()) {
+        editJournal = std::make_unique<EditJournal>(saveDirectory);
+    }
+}
+
+World::~World() {
+    // Let jobs still reading or flushing the journal finish before the final save
+    workers.waitIdle();
+    save();
 }
 
 void World::update(const glm::vec3& playerPos) {
-    int chunkX = static_cast<int>(std::floor(playerPos.x / static_cast<float>(CHUNK_SIZE)));
-    int chunkZ = static_cast<int>(std::floor(playerPos.z / static_cast<float>(CHUNK_SIZE)));
+    hasViewFrustum = false;
+    movePlayer(playerPos);
+    streamChunks();
+}
+
+void World::update(const glm::vec3& playerPos, const Frustum& view) {
+    viewFrustum = view;
+    hasViewFrustum = true;
+    movePlayer(playerPos);
+    streamChunks();
+}
+
+void World::update() {
+    streamChunks();
+}
+
+void World::movePlayer(const glm::vec3& playerPos) {
+    viewPosition = playerPos;
+    Observer next{chunkOf(playerPos), loadDistance, player.forward, hasViewFrustum ? viewStretch : 0.0f};
+    if (next.stretch != 0.0f) {
+        // Snapped to one of VIEW_SECTORS directions, so the window only changes when the
+        // camera turns by a sector. Looking straight up or down keeps the last one.
+        const glm::vec3 look = viewFrustum.forward();
+        if (look.x * look.x + look.z * look.z > 1e-4f) {
+            const float sector = 6.2831853f / VIEW_SECTORS;
+            const float angle = std::round(std::atan2(look.z, look.x) / sector) * sector;
+            next.forward = glm::vec2(std::cos(angle), std::sin(angle));
+        }
+    }
+    if (hasPlayer && next.center == player.center && next.forward == player.forward && next.stretch == player.stretch) {
+        return;
+    }
+
+    if (!hasPlayer || next.center != player.center) {
+        coldCache.dropOutside([&](const glm::ivec2& position) { return inColdRing(next.center, position); });
+    }
+    player = next;
+    if (!hasPlayer) {
+        playerObserver = nextObserverId++;
+        hasPlayer = true;
+        shiftObserver(observers[playerObserver], next, false);
+    } else {
+        shiftObserver(observers[playerObserver], next, true);
+    }
+}
+
+void World::streamChunks() {
+    updateCount++;
+    if (updateCount % THRASH_WINDOW == 0) {
+        std::erase_if(recentlyUnloaded, [&](const auto& entry) {
+            return updateCount - entry.second > THRASH_WINDOW;
+        });
+    }
+
+    // Unload first: the chunks leaving the window free the grid slots the new ones take
+    unloadReleasedChunks();
+    requestChunks();
+    integrateGeneratedChunks();
+    scheduleMeshing();
+    uploadMeshes();
+    evictMeshes();
+    scheduleFlush();
+}
+
+int64_t World::chunkKey(int x, int z) {
+    return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(z);
+}
+
+glm::ivec2 World::chunkOf(const glm::vec3& position) {
+    return {static_cast<int>(std::floor(position.x / static_cast<float>(CHUNK_SIZE))),
+            static_cast<int>(std::floor(position.z / static_cast<float>(CHUNK_SIZE)))};
+}
+
+float World::loadPriority(const glm::ivec2& position) const {
+    const float dx = (static_cast<float>(position.x) + 0.5f) * CHUNK_SIZE - viewPosition.x;
+    const float dz = (static_cast<float>(position.y) + 0.5f) * CHUNK_SIZE - viewPosition.z;
+    const float distance = std::sqrt(dx * dx + dz * dz) / CHUNK_SIZE;
+    if (!hasViewFrustum || distance < 1.5f) return distance;
+
+    // Grown by a chunk on each side: a visible chunk is only meshed once its neighbors
+    // are in, so those count as visible too
+    const glm::vec3 min((position.x - 1) * CHUNK_SIZE, 0.0f, (position.y - 1) * CHUNK_SIZE);
+    const glm::vec3 max(min.x + 3 * CHUNK_SIZE, static_cast<float>(CHUNK_HEIGHT), min.z + 3 * CHUNK_SIZE);
+    if (viewFrustum.isBoxVisible(min, max)) return distance;
+    // Farther than any chunk in the window
+    return distance + 2.0f * loadDistance;
+}
 
-    for (int x = chunkX - renderDistance; x <= chunkX + renderDistance; x++) {
-        for (int z = chunkZ - renderDistance; z <= chunkZ + renderDistance; z++) {
-            if (chunks.find(getChunkKey(x, z)) == chunks.end()) {
-                loadChunk(x, z);
+std::pair<int, int> World::windowColumn(const Observer& observer, int extra, int x) const {
+    const int dx = x - observer.center.x;
+    const int reach = observer.radius + extra;
+    const int cz = observer.center.y;
+    if (residencyShape == ResidencyShape::Square) {
+        if (std::abs(dx) > reach) return {1, 0};
+        return {cz - reach, cz + reach};
+    }
+    if (observer.stretch == 0.0f) {
+        // Chunk centers within reach + 0.5 of the observer's chunk center: dx² + dz² <= reach² + reach
+        const int limit = reach * reach + reach - dx * dx;
+        if (limit < 0) return {1, 0};
+        int half = static_cast<int>(std::sqrt(static_cast<float>(limit)));
+        while (half * half > limit) half--;
+        while ((half + 1) * (half + 1) <= limit) half++;
+        return {cz - half, cz + half};
+    }
+
+    // An ellipse as far ahead and to the sides as that circle (radius r), (1 - stretch) times
+    // as far behind: along² + (1 - stretch) across² <= a², with along measured from its
+    // center c ahead of the observer. Solved for dz in this column.
+    const float r = static_cast<float>(reach) + 0.5f;
+    const float a = r * (1.0f - 0.5f * observer.stretch);
+    const float c = r * 0.5f * observer.stretch;
+    const float k = 1.0f - observer.stretch;
+    const glm::vec2 f = observer.forward;
+    const float along = static_cast<float>(dx) * f.x - c; // At dz = 0; grows by f.y per dz
+    const float across = static_cast<float>(dx) * f.y;    // At dz = 0; shrinks by f.x per dz
+    const float qa = f.y * f.y + k * f.x * f.x;
+    const float qb = 2.0f * (along * f.y - k * across * f.x);
+    const float qc = along * along + k * across * across - a * a;
+    const float discriminant = qb * qb - 4.0f * qa * qc;
+    if (discriminant < 0.0f) return {1, 0};
+    const float root = std::sqrt(discriminant);
+    return {cz + static_cast<int>(std::ceil((-qb - root) / (2.0f * qa))),
+            cz + static_cast<int>(std::floor((-qb + root) / (2.0f * qa)))};
+}
+
+int World::windowExtent(const Observer& observer, int extra) const {
+    const int reach = observer.radius + extra;
+    if (residencyShape == ResidencyShape::Square || observer.stretch == 0.0f) return reach;
+    // Center offset plus the longer semi-axis, which is the one across the view
+    const float r = static_cast<float>(reach) + 0.5f;
+    return static_cast<int>(std::ceil(r * 0.5f * observer.stretch +
+                                      r * (1.0f - 0.5f * observer.stretch) / std::sqrt(1.0f - observer.stretch)));
+}
+
+bool World::inWindow(const Observer& observer, int extra, int x, int z) const {
+    const auto [first, last] = windowColumn(observer, extra, x);
+    return z >= first && z <= last;
+}
+
+template <typename Fn>
+void World::forEachEntering(const Observer* previous, const Observer& next, int extra, Fn&& fn) const {
+    const int extent = windowExtent(next, extra);
+    for (int x = next.center.x - extent; x <= next.center.x + extent; x++) {
+        const auto [first, last] = windowColumn(next, extra, x);
+        const auto [skipFirst, skipLast] = previous ? windowColumn(*previous, extra, x) : std::pair{1, 0};
+        for (int z = first; z <= last; z++) {
+            if (z >= skipFirst && z <= skipLast) {
+                // Skip the overlap with the previous window in one step
+                z = skipLast;
+                continue;
             }
+            fn(x, z);
         }
     }
-    unloadDistantChunks(playerPos);
 }
 
-void World::loadChunk(int x, int z) {
-    auto chunk = std::make_unique<Chunk>(glm::ivec2(x, z));
-    WorldGeneration::generateChunk(*chunk);
-    // Insert first so neighbors can see it
-    chunks[getChunkKey(x, z)] = std::move(chunk);
+World::ObserverId World::addObserver(const glm::vec3& position, int radius) {
+    const ObserverId id = nextObserverId++;
+    shiftObserver(observers[id], Observer{chunkOf(position), std::max(radius, 0)}, false);
+    return id;
+}
+
+void World::moveObserver(ObserverId id, const glm::vec3& position) {
+    auto it = observers.find(id);
+    if (it == observers.end()) return;
+    Observer next = it->second;
+    next.center = chunkOf(position);
+    if (next.center != it->second.center) shiftObserver(it->second, next, true);
+}
+
+void World::removeObserver(ObserverId id) {
+    auto it = observers.find(id);
+    if (it == observers.end()) return;
+    forEachEntering(nullptr, it->second, UNLOAD_MARGIN, [&](int x, int z) { releaseInterest(x, z); });
+    observers.erase(it);
+    if (hasPlayer && id == playerObserver) hasPlayer = false;
+}
+
+void World::setResidencyShape(ResidencyShape shape, float viewStretch) {
+    // Interest was counted in the old shape: take every window out and put it back in the new one
+    for (const auto& [id, observer] : observers) {
+        forEachEntering(nullptr, observer, UNLOAD_MARGIN, [&](int x, int z) { releaseInterest(x, z); });
+    }
+    residencyShape = shape;
+    this->viewStretch = std::clamp(viewStretch, 0.0f, MAX_VIEW_STRETCH);
+    for (auto& [id, observer] : observers) {
+        const Observer placed = observer;
+        shiftObserver(observer, placed, false);
+    }
+}
+
+uint32_t World::getInterest(int cx, int cz) const {
+    auto it = interest.find(chunkKey(cx, cz));
+    return it != interest.end() ? it->second : 0;
+}
+
+void World::shiftObserver(Observer& observer, const Observer& next, bool placed) {
+    const Observer previous = observer;
+    observer = next;
+    const Observer* before = placed ? &previous : nullptr;
 
-    // Generate mesh with world-aware neighbor checks for this chunk
-    chunks[getChunkKey(x, z)]->generateMeshWithWorld(*this);
+    // What the region left behind, then what it moved onto: the two windows swap roles
+    if (placed) forEachEntering(&next, previous, UNLOAD_MARGIN, [&](int x, int z) { releaseInterest(x, z); });
+    forEachEntering(before, next, UNLOAD_MARGIN, [&](int x, int z) { interest[chunkKey(x, z)]++; });
+    forEachEntering(before, next, 0, [&](int x, int z) { requestChunk(x, z, next.center); });
+}
+
+void World::releaseInterest(int cx, int cz) {
+    auto it = interest.find(chunkKey(cx, cz));
+    if (it == interest.end() || --it->second > 0) return;
+    interest.erase(it);
+    // A load still pending is dropped by requestChunks instead
+    if (Chunk* chunk = chunks.find(cx, cz)) {
+        chunk->releaseSerial = ++releaseCount;
+        unloadQueue.push_back({chunk->position, chunk->releaseSerial});
+    }
+}
 
-    // Refresh neighbor meshes so shared borders get culled properly
-    const int nx[4] = { x-1, x+1, x,   x   };
-    const int nz[4] = { z,   z,   z-1, z+1 };
-    for (int i = 0; i < 4; ++i) {
-        int64_t nkey = getChunkKey(nx[i], nz[i]);
-        auto it = chunks.find(nkey);
-        if (it != chunks.end()) {
-            it->second->generateMeshWithWorld(*this);
+void World::requestChunk(int cx, int cz, const glm::ivec2& observerCenter) {
+    const glm::ivec2 position(cx, cz);
+    if (Chunk* chunk = chunks.find(cx, cz)) {
+        // Loaded for another observer, never meshed because the player was not around
+        if (!chunk->hasMesh() && playerKeeps(position)) markMeshDirty(*chunk);
+        return;
+    }
+    if (generating.contains(chunkKey(cx, cz))) return;
+
+    const glm::vec2 offset(position - observerCenter);
+    const float priority = playerKeeps(position) ? loadPriority(position) : glm::length(offset);
+    LoadRequest request{position, priority, generationEpoch, {}};
+    // Coming back into range: decompressing is far cheaper than running the noise again
+    coldCache.take(position, request.packed);
+    generating[chunkKey(cx, cz)] = generationEpoch;
+    freshRequests.push_back(std::move(request));
+}
+
+void World::requestChunks() {
+    // Every queued request is also in generating
+    if (generating.empty()) return;
+
+    std::vector<LoadRequest> dropped;
+    size_t jobs;
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        for (LoadRequest& request : freshRequests) loadQueue.push_back(std::move(request));
+
+        // Rescore what is still waiting and drop what every observer has left behind.
+        // Requests outside the player's region keep the distance to the observer that made them.
+        for (size_t i = 0; i < loadQueue.size();) {
+            LoadRequest& request = loadQueue[i];
+            if (!interest.contains(chunkKey(request.position.x, request.position.y))) {
+                dropped.push_back(std::move(request));
+                request = std::move(loadQueue.back());
+                loadQueue.pop_back();
+                continue;
+            }
+            if (playerKeeps(request.position)) request.priority = loadPriority(request.position);
+            ++i;
         }
+        std::make_heap(loadQueue.begin(), loadQueue.end(), LoadOrder());
+
+        // Jobs already submitted take the best requests when they start; the rest wait for one
+        const size_t waiting = loadQueue.size() > queuedLoadJobs ? loadQueue.size() - queuedLoadJobs : 0;
+        jobs = waiting;
+        if (voxelBudgetBytes != 0) {
+            // Requests with a job, being built or waiting to be integrated already hold room
+            const size_t committed = chunks.count() + generating.size() - dropped.size() - waiting;
+            const size_t capacity = voxelBudgetBytes / Chunk::voxelBytes();
+            jobs = committed < capacity ? std::min(waiting, capacity - committed) : 0;
+        }
+        queuedLoadJobs += jobs;
+    }
+    freshRequests.clear();
+    for (LoadRequest& request : dropped) {
+        generating.erase(chunkKey(request.position.x, request.position.y));
+        // Still inside the cold ring, so keep it for when the player turns back
+        if (!request.packed.empty()) coldCache.put(request.position, std::move(request.packed));
+    }
+
+    // Each job takes whatever is best when it starts; jobs left over after requests were
+    // dropped find the queue empty and return
+    for (size_t i = 0; i < jobs; i++) {
+        workers.submit([this] { loadNextChunk(); });
     }
 }
 
-void World::unloadDistantChunks(const glm::vec3& playerPos) {
-    int centerX = static_cast<int>(std::floor(playerPos.x / static_cast<float>(CHUNK_SIZE)));
-    int centerZ = static_cast<int>(std::floor(playerPos.z / static_cast<float>(CHUNK_SIZE)));
+void World::loadNextChunk() {
+    LoadRequest request;
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        queuedLoadJobs--;
+        if (loadQueue.empty()) return;
+        std::pop_heap(loadQueue.begin(), loadQueue.end(), LoadOrder());
+        request = std::move(loadQueue.back());
+        loadQueue.pop_back();
+    }
 
-    auto it = chunks.begin();
-    while (it != chunks.end()) {
-        int64_t key = it->first;
-        int x = static_cast<int>(key >> 32);
-        int z = static_cast<int>(key & 0xFFFFFFFF);
+    GeneratedChunk result{std::make_unique<Chunk>(request.position), {}, request.epoch};
+    Chunk& chunk = *result.chunk;
+    chunk.stageMicros[stageIndex(ChunkStage::Requested)] = microsSince(request.requested);
 
-        if (std::abs(x - centerX) > renderDistance || std::abs(z - centerZ) > renderDistance) {
-            it = chunks.erase(it);
-        } else {
-            ++it;
+    auto start = std::chrono::steady_clock::now();
+    const bool cold = !request.packed.empty() && ChunkCompression::decompress(request.packed, chunk);
+    if (!cold) WorldGeneration::generateChunk(chunk);
+    chunk.stageMicros[stageIndex(ChunkStage::Generated)] = microsSince(start);
+    chunk.stage = ChunkStage::Generated;
+
+    // Cold chunks already hold their edits; generated ones get them replayed
+    start = std::chrono::steady_clock::now();
+    if (!cold && editJournal) editJournal->apply(chunk);
+    chunk.stageMicros[stageIndex(ChunkStage::Decorated)] = microsSince(start);
+    chunk.stage = ChunkStage::Decorated;
+
+    // The border stitch is added when the chunk is taken in
+    start = std::chrono::steady_clock::now();
+    LightEngine::computeChunkLight(chunk.snapshot(), result.light);
+    chunk.stageMicros[stageIndex(ChunkStage::Lit)] = microsSince(start);
+
+    std::lock_guard<std::mutex> lock(resultMutex);
+    generatedChunks.push_back(std::move(result));
+}
+
+void World::integrateGeneratedChunks() {
+    std::vector<GeneratedChunk> ready;
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        ready.swap(generatedChunks);
+    }
+
+    for (GeneratedChunk& result : ready) {
+        const glm::ivec2 position = result.chunk->position;
+        auto pending = generating.find(chunkKey(position.x, position.y));
+        if (pending != generating.end() && pending->second == result.epoch) generating.erase(pending);
+        if (result.epoch != generationEpoch) continue;
+
+        // Every observer moved on while it was being built
+        if (!interest.contains(chunkKey(position.x, position.y))) {
+            if (hasPlayer && inColdRing(player.center, position)) coldCache.store(*result.chunk);
+            continue;
+        }
+
+        loadedChunks++;
+        auto recent = recentlyUnloaded.find(chunkKey(position.x, position.y));
+        if (recent != recentlyUnloaded.end()) {
+            if (updateCount - recent->second <= THRASH_WINDOW) reloadedChunks++;
+            recentlyUnloaded.erase(recent);
+        }
+
+        // Insert first so neighbors can see it, then let light cross the borders
+        Chunk& chunk = *result.chunk;
+        chunks.insert(std::move(result.chunk));
+        const auto start = std::chrono::steady_clock::now();
+        lightEngine.onChunkLoaded(chunk, result.light);
+        chunk.stageMicros[stageIndex(ChunkStage::Lit)] += microsSince(start);
+        chunk.stage = ChunkStage::Lit;
+        for (ChunkStage stage : {ChunkStage::Requested, ChunkStage::Generated, ChunkStage::Decorated, ChunkStage::Lit}) {
+            recordStage(chunk, stage);
+        }
+
+        // Neighbor meshes drew open faces along the shared border until now. Most of
+        // them have not been meshed yet and are already waiting for this chunk.
+        markMeshDirty(chunk);
+        markMeshDirty(position.x - 1, position.y);
+        markMeshDirty(position.x + 1, position.y);
+        markMeshDirty(position.x, position.y - 1);
+        markMeshDirty(position.x, position.y + 1);
+    }
+}
+
+void World::scheduleMeshing() {
+    // A first mesh built against a missing neighbor emits a wall of border faces that is
+    // thrown away as soon as the neighbor arrives. Such chunks leave the set instead:
+    // loading the neighbor marks them again. Chunks that are already drawn are remeshed
+    // regardless, so edits near the edge of the world still show up. A chunk edited
+    // while its job runs stays in the set until the first result lands.
+    std::vector<std::pair<float, Chunk*>> stale;
+    size_t kept = 0;
+    for (const glm::ivec2& position : dirtyMeshes) {
+        Chunk* chunk = chunks.find(position.x, position.y);
+        if (!chunk || !chunk->needsMeshUpdate) continue;
+        // Before any job can read it. Chunks only waiting for their job to land are
+        // unchanged and keep the snapshot they have, so later edits need not copy it.
+        if (chunk->publishedRevision != chunk->getContentRevision()) {
+            published.publish(std::make_shared<const ChunkSnapshot>(chunk->snapshot()));
+            chunk->publishedRevision = chunk->getContentRevision();
+        }
+        if (chunk->meshTicket != 0) {
+            dirtyMeshes[kept++] = position;
+            continue;
+        }
+        // Cleared here so a second entry for the same chunk is skipped. Chunks only other
+        // observers keep are not drawn; the player's window marks them again on arrival.
+        chunk->needsMeshUpdate = false;
+        if (!playerKeeps(position)) continue;
+        if (!chunk->hasMesh() && !neighborsReached(position, ChunkStage::Meshed)) continue;
+        stale.emplace_back(loadPriority(position), chunk);
+    }
+    dirtyMeshes.resize(kept);
+    // Same order as loading, so what the camera faces is drawn first
+    std::sort(stale.begin(), stale.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // Under a mesh budget, first meshes start while an average one fits below 15/16 of it,
+    // which leaves room for meshes larger than the average before evictMeshes steps in.
+    // Until one has landed there is no average, so they start one at a time.
+    const size_t admitLimit = meshBudgetBytes - meshBudgetBytes / 16;
+    const size_t average = meshedChunks > 0 ? meshBytes / meshedChunks : admitLimit;
+    size_t projected = meshBytes + meshJobs * average;
+    meshesWaitingForRoom = false;
+    for (const auto& [priority, chunk] : stale) {
+        if (meshBudgetBytes != 0 && !chunk->hasMesh()) {
+            if (projected + average > admitLimit) {
+                // Waits in the set for room
+                meshesWaitingForRoom = true;
+                chunk->needsMeshUpdate = true;
+                dirtyMeshes.push_back(chunk->position);
+                continue;
+            }
+            projected += average;
+        }
+
+        chunk->meshTicket = ++nextMeshTicket;
+        meshJobs++;
+        meshesBuilt++;
+
+        workers.submit([this, position = chunk->position, ticket = chunk->meshTicket] {
+            const auto start = std::chrono::steady_clock::now();
+            // Every changed chunk was published above, so the neighborhood is at least as
+            // new as when the job was queued
+            std::array<std::optional<ChunkSnapshot>, 9> around;
+            for (int dz = -1; dz <= 1; dz++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if (auto snapshot = published.find(position.x + dx, position.y + dz)) {
+                        around[(dz + 1) * 3 + (dx + 1)] = *snapshot;
+                    }
+                }
+            }
+            BuiltMesh mesh{position, ticket, {}};
+            // Unloaded since; the empty result is dropped like any other stale one
+            if (around[4]) {
+                auto padded = std::make_unique<PaddedChunk>();
+                padded->gather(around);
+                ChunkMesher::buildMesh(*padded, mesh.vertices);
+            }
+            mesh.buildMicros = microsSince(start);
+            mesh.built = std::chrono::steady_clock::now();
+
+            std::lock_guard<std::mutex> lock(resultMutex);
+            builtMeshes.push_back(std::move(mesh));
+        });
+    }
+}
+
+void World::uploadMeshes() {
+    lastUploadedChunks = 0;
+    lastUploadedBytes = 0;
+    while (true) {
+        BuiltMesh mesh;
+        {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            if (builtMeshes.empty()) break;
+            // Always make progress, even when a single mesh is over the byte budget
+            if (lastUploadedChunks > 0 && (lastUploadedChunks >= uploadBudgetChunks ||
+                                           lastUploadedBytes >= uploadBudgetBytes)) break;
+            mesh = std::move(builtMeshes.front());
+            builtMeshes.pop_front();
+        }
+        meshJobs--;
+
+        // Dropped if the chunk was unloaded while the job ran
+        Chunk* chunk = chunks.find(mesh.position.x, mesh.position.y);
+        if (!chunk || chunk->meshTicket != mesh.ticket) continue;
+        chunk->meshTicket = 0;
+        lastUploadedChunks++;
+        lastUploadedBytes += mesh.vertices.size() * sizeof(float);
+        meshBytes -= chunk->meshBytes();
+        if (!chunk->hasMesh()) meshedChunks++;
+        chunk->setMesh(std::move(mesh.vertices));
+        meshBytes += chunk->meshBytes();
+
+        chunk->stageMicros[stageIndex(ChunkStage::Meshed)] = mesh.buildMicros;
+        chunk->stageMicros[stageIndex(ChunkStage::Uploaded)] = microsSince(mesh.built);
+        recordStage(*chunk, ChunkStage::Meshed);
+        recordStage(*chunk, ChunkStage::Uploaded);
+        // Edited while the job ran: drawn, but another mesh is on its way
+        chunk->stage = chunk->needsMeshUpdate ? ChunkStage::Lit : ChunkStage::Uploaded;
+    }
+
+    // Meshes held back by the budget
+    std::lock_guard<std::mutex> lock(resultMutex);
+    for (const BuiltMesh& mesh : builtMeshes) {
+        Chunk* chunk = chunks.find(mesh.position.x, mesh.position.y);
+        if (chunk && chunk->meshTicket == mesh.ticket && !chunk->needsMeshUpdate) chunk->stage = ChunkStage::Meshed;
+    }
+}
+
+bool World::neighborsReached(const glm::ivec2& position, ChunkStage stage) const {
+    const StageDependency& dependency = STAGE_DEPENDENCIES[stageIndex(stage)];
+    if (dependency.neighbors == StageNeighbors::None) return true;
+    for (int dz = -1; dz <= 1; dz++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            if ((dx == 0 && dz == 0) || (dependency.neighbors == StageNeighbors::Edges && dx != 0 && dz != 0)) continue;
+            const Chunk* neighbor = chunks.find(position.x + dx, position.y + dz);
+            if (!neighbor || neighbor->stage < dependency.neighborsAt) return false;
+        }
+    }
+    return true;
+}
+
+void World::recordStage(const Chunk& chunk, ChunkStage stage) {
+    PipelineStats::Stage& totals = pipeline.stages[stageIndex(stage)];
+    const double micros = chunk.stageMicros[stageIndex(stage)];
+    totals.timed++;
+    totals.totalMicros += micros;
+    totals.maxMicros = std::max(totals.maxMicros, micros);
+}
+
+void World::evictMeshes() {
+    const bool over = meshBytes > meshBudgetBytes;
+    if (meshBudgetBytes == 0 || (!over && !meshesWaitingForRoom)) return;
+
+    // Meshes nobody draws go first, then drawn ones from the back of the load order. Drawn
+    // ones only make room for meshes larger than expected, not for meshes still waiting.
+    std::vector<std::pair<float, Chunk*>> meshed;
+    chunks.forEach([&](Chunk& chunk) {
+        if (!chunk.hasMesh()) return;
+        const bool drawn = playerKeeps(chunk.position);
+        meshed.emplace_back(drawn ? loadPriority(chunk.position) : std::numeric_limits<float>::infinity(), &chunk);
+    });
+    std::sort(meshed.begin(), meshed.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    const size_t target = meshBudgetBytes - meshBudgetBytes / 8;
+    for (const auto& [priority, chunk] : meshed) {
+        if (meshBytes <= target || (!over && priority != std::numeric_limits<float>::infinity())) break;
+        meshBytes -= chunk->meshBytes();
+        meshedChunks--;
+        chunk->clearMesh();
+        chunk->stage = ChunkStage::Lit;
+        evictedMeshes++;
+        // Drawn ones are meshed again once there is room
+        if (playerKeeps(chunk->position)) markMeshDirty(*chunk);
+    }
+}
+
+void World::setUploadBudget(size_t maxBytes, size_t maxChunks) {
+    uploadBudgetBytes = maxBytes;
+    uploadBudgetChunks = maxChunks;
+}
+
+void World::setUnloadBudget(size_t maxChunks) {
+    unloadBudget = maxChunks;
+}
+
+void World::setMemoryBudget(size_t maxVoxelBytes, size_t maxMeshBytes) {
+    voxelBudgetBytes = maxVoxelBytes;
+    meshBudgetBytes = maxMeshBytes;
+}
+
+StreamingStats World::getStreamingStats() const {
+    StreamingStats stats;
+    stats.generating = generating.size();
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        stats.uploadsWaiting = builtMeshes.size();
+    }
+    stats.meshing = meshJobs - stats.uploadsWaiting;
+    stats.uploadedChunks = lastUploadedChunks;
+    stats.uploadedBytes = lastUploadedBytes;
+    stats.unloadsWaiting = unloadQueue.size();
+    stats.residentChunks = chunks.count();
+    stats.loadedChunks = loadedChunks;
+    stats.unloadedChunks = unloadedChunks;
+    stats.reloadedChunks = reloadedChunks;
+    stats.meshesBuilt = meshesBuilt;
+    return stats;
+}
+
+MemoryStats World::getMemoryStats() const {
+    MemoryStats stats;
+    stats.voxelBytes = chunks.count() * Chunk::voxelBytes();
+    stats.meshBytes = meshBytes;
+    stats.voxelBudget = voxelBudgetBytes;
+    stats.meshBudget = meshBudgetBytes;
+    chunks.forEach([&](const Chunk& chunk) {
+        if (!interest.contains(chunkKey(chunk.position.x, chunk.position.y))) stats.cachedChunks++;
+    });
+    stats.evictedChunks = evictedChunks;
+    stats.evictedMeshes = evictedMeshes;
+    return stats;
+}
+
+PipelineStats World::getPipelineStats() const {
+    PipelineStats stats = pipeline;
+    stats.stages[stageIndex(ChunkStage::Requested)].chunks = generating.size();
+    chunks.forEach([&](const Chunk& chunk) { stats.stages[stageIndex(chunk.stage)].chunks++; });
+    return stats;
+}
+
+std::optional<ChunkStage> World::getChunkStage(int cx, int cz) const {
+    if (const Chunk* chunk = chunks.find(cx, cz)) return chunk->stage;
+    if (generating.contains(chunkKey(cx, cz))) return ChunkStage::Requested;
+    return std::nullopt;
+}
+
+void World::unloadReleasedChunks() {
+    // Under a voxel budget released chunks stay until the chunks waiting to load need their room
+    const bool budgeted = voxelBudgetBytes != 0;
+    const size_t capacity = voxelBudgetBytes / Chunk::voxelBytes();
+    size_t unloaded = 0;
+    while (unloaded < unloadBudget && !unloadQueue.empty()) {
+        if (budgeted && chunks.count() + generating.size() <= capacity) return;
+        const ReleasedChunk released = unloadQueue.front();
+        unloadQueue.pop_front();
+        const Chunk* chunk = chunks.find(released.position.x, released.position.y);
+        if (!chunk || chunk->releaseSerial != released.serial ||
+            interest.contains(chunkKey(released.position.x, released.position.y))) {
+            continue;
         }
+        unloadChunk(chunks.remove(released.position.x, released.position.y));
+        unloaded++;
+        if (budgeted) evictedChunks++;
     }
+
+    // Observers want more than fits
+    if (budgeted && unloadQueue.empty()) evictWantedChunks(unloadBudget - unloaded);
 }
 
-void World::render() const {
-    for (const auto& [key, chunk] : chunks) {
-        chunk->render();
+void World::evictWantedChunks(size_t maxChunks) {
+    const size_t capacity = voxelBudgetBytes / Chunk::voxelBytes();
+    const size_t over = chunks.count() > capacity ? chunks.count() - capacity : 0;
+
+    // Requests that will not get a job before there is room, best first. Only the player's
+    // distance ranks chunks of different observers against each other.
+    std::vector<float> waiting;
+    if (hasPlayer) {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        for (const LoadRequest& request : loadQueue) waiting.push_back(loadPriority(request.position));
+        std::sort(waiting.begin(), waiting.end());
+        waiting.erase(waiting.begin(), waiting.begin() + std::min(queuedLoadJobs, waiting.size()));
+    }
+    if (over == 0 && waiting.empty()) return;
+
+    std::vector<std::pair<float, glm::ivec2>> wanted;
+    chunks.forEach([&](const Chunk& chunk) { wanted.emplace_back(loadPriority(chunk.position), chunk.position); });
+    const size_t candidates = std::min({maxChunks, wanted.size(), over + waiting.size()});
+    std::partial_sort(wanted.begin(), wanted.begin() + candidates, wanted.end(),
+                      [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    const glm::ivec2 viewCenter = chunkOf(viewPosition);
+    for (size_t i = 0; i < candidates; i++) {
+        // Past what a lowered budget forces out, a chunk only makes way for one waiting that
+        // is more than a chunk nearer, so two at about the same distance do not swap back and forth
+        if (i >= over && wanted[i].first <= waiting[i - over] + 1.0f) break;
+        const glm::ivec2 position = wanted[i].second;
+        unloadChunk(chunks.remove(position.x, position.y));
+        evictedChunks++;
+        // Loads again, from the cold cache when near, once it is among the best that fit
+        requestChunk(position.x, position.y, viewCenter);
     }
 }
 
-int64_t World::getChunkKey(int x, int z) const {
-    return ((int64_t)x << 32) | (int64_t)z;
+void World::unloadChunk(std::unique_ptr<Chunk> chunk) {
+    const glm::ivec2 position = chunk->position;
+    published.retire(position.x, position.y);
+    if (hasPlayer && inColdRing(player.center, position)) coldCache.store(*chunk);
+    farField.insertChunk(chunk->snapshot());
+    meshBytes -= chunk->meshBytes();
+    if (chunk->hasMesh()) meshedChunks--;
+    recentlyUnloaded[chunkKey(position.x, position.y)] = updateCount;
+    unloadedChunks++;
+}
+
+void World::scheduleFlush() {
+    if (!editJournal || flushRunning || !editJournal->hasUnflushedEdits()) return;
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastFlush < SAVE_INTERVAL) return;
+
+    lastFlush = now;
+    flushRunning = true;
+    workers.submit([this] {
+        editJournal->flush();
+        if (editJournal->needsCompaction()) editJournal->compact();
+        flushRunning = false;
+    });
+}
+
+void World::save() {
+    if (editJournal) editJournal->flush();
 }
 
 Block World::getBlockGlobal(int gx, int gy, int gz) const {
     if (gy < 0 || gy >= CHUNK_HEIGHT) return Block{BlockType::AIR};
 
-    auto floorDiv = [](int a, int b) -> int {
-        // floor division for negatives
-        int q = a / b;
-        int r = a % b;
-        if ((r != 0) && ((r > 0) != (b > 0)) && (a < 0)) --q;
-        return q;
-    };
-
     int cx = floorDiv(gx, CHUNK_SIZE);
     int cz = floorDiv(gz, CHUNK_SIZE);
 
     int lx = gx - cx * CHUNK_SIZE;
     int lz = gz - cz * CHUNK_SIZE;
 
-    int64_t key = getChunkKey(cx, cz);
-    auto it = chunks.find(key);
-    if (it == chunks.end()) {
+    const Chunk* chunk = chunks.find(cx, cz);
+    if (!chunk) {
         return Block{BlockType::AIR};
     }
-    return it->second->getBlock(lx, gy, lz);
+    return chunk->getBlock(lx, gy, lz);
+}
+
+void World::setBlockGlobal(int gx, int gy, int gz, Block block) {
+    if (gy < 0 || gy >= CHUNK_HEIGHT) return;
+
+    const int cx = floorDiv(gx, CHUNK_SIZE);
+    const int cz = floorDiv(gz, CHUNK_SIZE);
+    Chunk* chunk = getChunk(cx, cz);
+    if (!chunk) return;
+
+    const int lx = gx - cx * CHUNK_SIZE;
+    const int lz = gz - cz * CHUNK_SIZE;
+    chunk->setBlock(lx, gy, lz, block);
+    if (editJournal) editJournal->record(chunk->position, Chunk::blockIndex(lx, gy, lz), block);
+    markMeshDirty(*chunk);
+
+    // Neighbor meshes cull against this block when it sits on the border
+    if (lx == 0) markMeshDirty(cx - 1, cz);
+    if (lx == CHUNK_SIZE - 1) markMeshDirty(cx + 1, cz);
+    if (lz == 0) markMeshDirty(cx, cz - 1);
+    if (lz == CHUNK_SIZE - 1) markMeshDirty(cx, cz + 1);
+
+    lightEngine.onBlockChanged(gx, gy, gz);
+}
+
+uint8_t World::getLightGlobal(int gx, int gy, int gz) const {
+    if (gy >= CHUNK_HEIGHT) return FULL_SKY_LIGHT;
+    if (gy < 0) return 0;
+
+    const int cx = floorDiv(gx, CHUNK_SIZE);
+    const int cz = floorDiv(gz, CHUNK_SIZE);
+    const Chunk* chunk = getChunk(cx, cz);
+    if (!chunk) return FULL_SKY_LIGHT;
+    return chunk->getLight(gx - cx * CHUNK_SIZE, gy, gz - cz * CHUNK_SIZE);
+}
+
+bool World::copyRegion(const glm::ivec3& min, const glm::ivec3& max, std::span<Block> out) const {
+    const glm::ivec3 size = glm::max(max - min, glm::ivec3(0));
+    const size_t rowStride = static_cast<size_t>(size.x);
+    const size_t layerStride = rowStride * static_cast<size_t>(size.z);
+    if (out.size() < layerStride * static_cast<size_t>(size.y)) return false;
+    if (layerStride == 0 || size.y == 0) return true;
+
+    // Layers outside the world are air
+    const int yBegin = std::min(std::max(min.y, 0), max.y);
+    const int yEnd = std::max(std::min(max.y, CHUNK_HEIGHT), yBegin);
+    std::fill_n(out.begin(), static_cast<size_t>(yBegin - min.y) * layerStride, Block{BlockType::AIR});
+    std::fill(out.begin() + static_cast<size_t>(yEnd - min.y) * layerStride,
+              out.begin() + static_cast<size_t>(size.y) * layerStride, Block{BlockType::AIR});
+    if (yBegin == yEnd) return true;
+
+    const int cxEnd = floorDiv(max.x - 1, CHUNK_SIZE);
+    const int czEnd = floorDiv(max.z - 1, CHUNK_SIZE);
+    for (int cz = floorDiv(min.z, CHUNK_SIZE); cz <= czEnd; cz++) {
+        const int zBegin = std::max(min.z, cz * CHUNK_SIZE);
+        const int zEnd = std::min(max.z, (cz + 1) * CHUNK_SIZE);
+        for (int cx = floorDiv(min.x, CHUNK_SIZE); cx <= cxEnd; cx++) {
+            const int xBegin = std::max(min.x, cx * CHUNK_SIZE);
+            const int xEnd = std::min(max.x, (cx + 1) * CHUNK_SIZE);
+            const size_t width = static_cast<size_t>(xEnd - xBegin);
+            const Chunk* chunk = chunks.find(cx, cz);
+
+            for (int y = yBegin; y < yEnd; y++) {
+                const Block* layer = chunk ? chunk->section(y / SECTION_HEIGHT).blocks : nullptr;
+                for (int z = zBegin; z < zEnd; z++) {
+                    Block* dst = out.data() + static_cast<size_t>(y - min.y) * layerStride +
+                                 static_cast<size_t>(z - min.z) * rowStride + static_cast<size_t>(xBegin - min.x);
+                    if (!layer) {
+                        std::fill_n(dst, width, Block{BlockType::AIR});
+                        continue;
+                    }
+                    const int src = Chunk::blockIndex(xBegin - cx * CHUNK_SIZE, y % SECTION_HEIGHT, z - cz * CHUNK_SIZE);
+                    std::copy_n(layer + src, width, dst);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+BlockRegionView World::readRegion(const glm::ivec3& min, const glm::ivec3& max, std::span<Block> buffer) const {
+    BlockRegionView view;
+    const glm::ivec3 size = glm::max(max - min, glm::ivec3(0));
+    const int cx = floorDiv(min.x, CHUNK_SIZE);
+    const int cz = floorDiv(min.z, CHUNK_SIZE);
+    const bool oneSection = size.x > 0 && size.y > 0 && size.z > 0 && min.y >= 0 && max.y <= CHUNK_HEIGHT &&
+                            floorDiv(max.x - 1, CHUNK_SIZE) == cx && floorDiv(max.z - 1, CHUNK_SIZE) == cz &&
+                            min.y / SECTION_HEIGHT == (max.y - 1) / SECTION_HEIGHT;
+    if (oneSection) {
+        if (const Chunk* chunk = chunks.find(cx, cz)) {
+            view.section = chunk->shareSection(min.y / SECTION_HEIGHT);
+            view.data = view.section->blocks +
+                        Chunk::blockIndex(min.x - cx * CHUNK_SIZE, min.y % SECTION_HEIGHT, min.z - cz * CHUNK_SIZE);
+            view.size = size;
+            view.rowStride = CHUNK_SIZE;
+            view.layerStride = CHUNK_AREA;
+            return view;
+        }
+    }
+
+    if (!copyRegion(min, max, buffer)) return view;
+    view.data = buffer.data();
+    view.size = size;
+    view.rowStride = size.x;
+    view.layerStride = size.x * size.z;
+    return view;
+}
+
+bool World::startRay(const glm::vec3& origin, const glm::vec3& dir, float maxDist, RayState& ray) {
+    const float len = glm::length(dir);
+    if (len == 0.0f) return false;
+    const glm::vec3 d = dir / len;
+    const float inf = std::numeric_limits<float>::infinity();
+    ray.origin = origin;
+    ray.dir = d;
+    ray.invDir = glm::vec3(d.x != 0.0f ? 1.0f / d.x : inf, d.y != 0.0f ? 1.0f / d.y : inf,
+                           d.z != 0.0f ? 1.0f / d.z : inf);
+    ray.step = glm::ivec3((d.x > 0.0f) - (d.x < 0.0f), (d.y > 0.0f) - (d.y < 0.0f), (d.z > 0.0f) - (d.z < 0.0f));
+
+    // Nothing is solid outside the chunk layers; start where the ray enters them
+    ray.t = 0.0f;
+    ray.tEnd = maxDist;
+    ray.normal = glm::ivec3(0);
+    if (ray.step.y != 0) {
+        float t0 = -origin.y * ray.invDir.y;
+        float t1 = (static_cast<float>(CHUNK_HEIGHT) - origin.y) * ray.invDir.y;
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 > 0.0f) {
+            ray.t = t0;
+            ray.normal.y = -ray.step.y;
+        }
+        ray.tEnd = std::min(ray.tEnd, t1);
+    } else if (origin.y < 0.0f || origin.y >= static_cast<float>(CHUNK_HEIGHT)) {
+        return false;
+    }
+    if (ray.t > ray.tEnd) return false;
+
+    ray.cell = glm::ivec3(glm::floor(origin + d * ray.t));
+    if (ray.normal.y != 0) ray.cell.y = ray.step.y > 0 ? 0 : CHUNK_HEIGHT - 1;
+    return true;
+}
+
+template <typename ChunkData>
+World::RayStep World::marchChunk(RayState& state, const ChunkData* chunk, const glm::ivec2& position, RaycastHit& hit) {
+    const float inf = std::numeric_limits<float>::infinity();
+    const glm::ivec3 base(position.x * CHUNK_SIZE, 0, position.y * CHUNK_SIZE);
+    // Work on a local copy so the state can live in registers; only a ray that goes on
+    // needs it written back
+    RayState ray = state;
+    glm::ivec3& cell = ray.cell;
+
+    // Each pass finds the largest box known to be empty around the cell and moves to the
+    // cell just past the face the ray leaves it through. Occupied bricks are walked
+    // voxel by voxel.
+    while (cell.y >= 0 && cell.y < CHUNK_HEIGHT) {
+        const glm::ivec3 local = cell - base;
+        if (local.x < 0 || local.x >= CHUNK_SIZE || local.z < 0 || local.z >= CHUNK_SIZE) {
+            state = ray;
+            return RayStep::NextChunk;
+        }
+
+        glm::ivec3 boxMin = base;
+        glm::ivec3 boxMax = base + glm::ivec3(CHUNK_SIZE, CHUNK_HEIGHT, CHUNK_SIZE);
+        if (!chunk || chunk->isEmpty()) {
+            // The whole column of the chunk
+        } else if (local.y > chunk->getMaxSolidY()) {
+            boxMin.y = chunk->getMaxSolidY() + 1;
+        } else if (local.y < chunk->getMinSolidY()) {
+            boxMax.y = chunk->getMinSolidY();
+        } else if (!chunk->isBrickOccupied(local.x, local.y, local.z)) {
+            boxMin = base + local / BRICK_SIZE * BRICK_SIZE;
+            boxMax = boxMin + glm::ivec3(BRICK_SIZE);
+        } else {
+            // Something is solid in this brick: plain DDA through its voxels
+            boxMin = base + local / BRICK_SIZE * BRICK_SIZE;
+            boxMax = boxMin + glm::ivec3(BRICK_SIZE);
+            glm::vec3 tNext;
+            for (int a = 0; a < 3; a++) {
+                const float face = static_cast<float>(ray.step[a] > 0 ? cell[a] + 1 : cell[a]);
+                tNext[a] = ray.step[a] == 0 ? inf : (face - ray.origin[a]) * ray.invDir[a];
+            }
+            while (true) {
+                const glm::ivec3 inChunk = cell - base;
+                const Block block = chunk->getBlock(inChunk.x, inChunk.y, inChunk.z);
+                if (block.isSolid()) {
+                    hit.block = cell;
+                    hit.normal = ray.normal;
+                    hit.distance = ray.t;
+                    hit.type = block.type;
+                    return RayStep::Hit;
+                }
+                const int axis = tNext.x < tNext.y ? (tNext.x < tNext.z ? 0 : 2) : (tNext.y < tNext.z ? 1 : 2);
+                if (tNext[axis] > ray.tEnd) return RayStep::Miss;
+                ray.t = std::max(ray.t, tNext[axis]);
+                tNext[axis] += std::abs(ray.invDir[axis]);
+                cell[axis] += ray.step[axis];
+                ray.normal = glm::ivec3(0);
+                ray.normal[axis] = -ray.step[axis];
+                if (cell[axis] < boxMin[axis] || cell[axis] >= boxMax[axis]) break;
+            }
+            continue;
+        }
+
+        int axis = 0;
+        float tExit = inf;
+        for (int a = 0; a < 3; a++) {
+            if (ray.step[a] == 0) continue;
+            const float face = static_cast<float>(ray.step[a] > 0 ? boxMax[a] : boxMin[a]);
+            const float ta = (face - ray.origin[a]) * ray.invDir[a];
+            if (ta < tExit) {
+                tExit = ta;
+                axis = a;
+            }
+        }
+        if (tExit > ray.tEnd) return RayStep::Miss;
+
+        // Off the exit axis the cell is wherever the ray is by then, kept inside the box
+        // so rounding cannot send it back or past a neighbor
+        const glm::vec3 exitPoint = ray.origin + ray.dir * tExit;
+        for (int a = 0; a < 3; a++) {
+            if (a == axis) continue;
+            cell[a] = std::clamp(static_cast<int>(std::floor(exitPoint[a])), boxMin[a], boxMax[a] - 1);
+        }
+        cell[axis] = ray.step[axis] > 0 ? boxMax[axis] : boxMin[axis] - 1;
+        ray.normal = glm::ivec3(0);
+        ray.normal[axis] = -ray.step[axis];
+        ray.t = std::max(ray.t, tExit);
+    }
+    return RayStep::Miss;
+}
+
+bool World::raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, RaycastHit& hit) const {
+    RayState ray;
+    if (!startRay(origin, dir, maxDist, ray)) return false;
+    while (true) {
+        const glm::ivec2 position(floorDiv(ray.cell.x, CHUNK_SIZE), floorDiv(ray.cell.z, CHUNK_SIZE));
+        const RayStep step = marchChunk(ray, chunks.find(position.x, position.y), position, hit);
+        if (step != RayStep::NextChunk) return step == RayStep::Hit;
+    }
+}
+
+size_t World::tracePacket(std::span<const RayQuery> rays, std::span<const uint32_t> rayIndices,
+                          std::span<RaycastHit> hits) const {
+    std::array<RayState, PACKET_RAYS> states;
+    // Rays waiting at the chunk column they are about to enter. The rays of a packet leave
+    // the same chunk in the same quadrant, so each step takes them one column further
+    // out: tracing the packet front by front visits each column once.
+    struct Waiting {
+        glm::ivec2 position;
+        uint32_t ray;
+    };
+    std::array<Waiting, PACKET_RAYS> buffers[2];
+    size_t count = 0;
+    for (uint32_t ray = 0; ray < rayIndices.size(); ray++) {
+        const RayQuery& query = rays[rayIndices[ray]];
+        if (!startRay(query.origin, query.dir, query.maxDist, states[ray])) continue;
+        const glm::ivec3& cell = states[ray].cell;
+        buffers[0][count++] = {{floorDiv(cell.x, CHUNK_SIZE), floorDiv(cell.z, CHUNK_SIZE)}, ray};
+    }
+
+    size_t found = 0;
+    for (int front = 0; count > 0; front ^= 1) {
+        Waiting* current = buffers[front].data();
+        Waiting* next = buffers[front ^ 1].data();
+        size_t nextCount = 0;
+        // A front spans few columns, so take one at a time and march every ray waiting
+        // there; marched entries are dropped by moving the last one into their place
+        while (count > 0) {
+            const glm::ivec2 position = current[0].position;
+            // Held while the column's rays march, so an unload cannot free it meanwhile
+            const std::shared_ptr<const ChunkSnapshot> chunk = published.find(position.x, position.y);
+            for (size_t i = 0; i < count;) {
+                if (current[i].position != position) {
+                    i++;
+                    continue;
+                }
+                const uint32_t index = current[i].ray;
+                current[i] = current[--count];
+                RayState& ray = states[index];
+                switch (marchChunk(ray, chunk.get(), position, hits[rayIndices[index]])) {
+                case RayStep::Hit:
+                    found++;
+                    break;
+                case RayStep::Miss:
+                    break;
+                case RayStep::NextChunk:
+                    next[nextCount++] = {{floorDiv(ray.cell.x, CHUNK_SIZE), floorDiv(ray.cell.z, CHUNK_SIZE)}, index};
+                    break;
+                }
+            }
+        }
+        count = nextCount;
+    }
+    return found;
+}
+
+// Stable sort on the high 32 bits: three counting passes of 11 bits each
+static void sortByHighWord(std::vector<uint64_t>& values) {
+    std::vector<uint64_t> scratch(values.size());
+    for (int shift = 32; shift < 64; shift += 11) {
+        std::array<uint32_t, 2048> offsets{};
+        for (uint64_t v : values) offsets[(v >> shift) & 2047]++;
+        uint32_t sum = 0;
+        for (uint32_t& offset : offsets) {
+            const uint32_t n = offset;
+            offset = sum;
+            sum += n;
+        }
+        for (uint64_t v : values) scratch[offsets[(v >> shift) & 2047]++] = v;
+        values.swap(scratch);
+    }
+}
+
+size_t World::raycastBatch(std::span<const RayQuery> rays, std::span<RaycastHit> hits) {
+    const size_t rayCount = std::min(rays.size(), hits.size());
+
+    // Shared with the worker jobs, which may only get to run after this call returned
+    struct Batch {
+        // Packet key in the high word, index into rays and hits in the low word
+        std::vector<uint64_t> keyed;
+        std::vector<uint32_t> order;
+        std::vector<std::pair<uint32_t, uint32_t>> packets; // [begin, end) in order
+        std::atomic<size_t> nextPacket{0};
+        std::atomic<size_t> found{0};
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t finishedPackets = 0;
+    };
+    auto batch = std::make_shared<Batch>();
+
+    // Key on the chunk the ray leaves from, then its direction quadrant in the xz plane.
+    // Grouping only decides which rays share chunk lookups, never a result: chunk
+    // coordinates wrap at 2^15, and rays coming from above or below the chunk layers
+    // enter them somewhere else, which only costs some sharing.
+    batch->keyed.resize(rayCount);
+    for (size_t i = 0; i < rayCount; i++) {
+        hits[i] = RaycastHit{glm::ivec3(0), glm::ivec3(0), 0.0f, BlockType::AIR};
+        const glm::ivec2 chunk = chunkOf(rays[i].origin);
+        const uint64_t cx = static_cast<uint32_t>(chunk.x) & 0x7FFF;
+        const uint64_t cz = static_cast<uint32_t>(chunk.y) & 0x7FFF;
+        const uint64_t quadrant = (rays[i].dir.x < 0.0f ? 1u : 0u) | (rays[i].dir.z < 0.0f ? 2u : 0u);
+        batch->keyed[i] = (cx << 49) | (cz << 34) | (quadrant << 32) | i;
+    }
+    sortByHighWord(batch->keyed);
+
+    const std::vector<uint64_t>& keyed = batch->keyed;
+    batch->order.reserve(keyed.size());
+    for (size_t i = 0; i < keyed.size(); i++) {
+        const bool sameKey = i > 0 && (keyed[i] >> 32) == (keyed[i - 1] >> 32);
+        if (!sameKey || i - batch->packets.back().first == PACKET_RAYS) {
+            batch->packets.push_back({static_cast<uint32_t>(i), static_cast<uint32_t>(i)});
+        }
+        batch->order.push_back(static_cast<uint32_t>(keyed[i]));
+        batch->packets.back().second = static_cast<uint32_t>(i + 1);
+    }
+
+    const size_t packetCount = batch->packets.size();
+    auto work = [this, batch, rays, hits, packetCount] {
+        size_t traced = 0;
+        size_t found = 0;
+        for (size_t p; (p = batch->nextPacket.fetch_add(1)) < packetCount; traced++) {
+            const auto [begin, end] = batch->packets[p];
+            found += tracePacket(rays, std::span<const uint32_t>(batch->order).subspan(begin, end - begin), hits);
+        }
+        if (traced == 0) return;
+        batch->found += found;
+        std::lock_guard<std::mutex> lock(batch->mutex);
+        batch->finishedPackets += traced;
+        if (batch->finishedPackets == packetCount) batch->done.notify_all();
+    };
+
+    // Workers busy with chunk jobs simply find every packet taken when they get to this.
+    // Only the packets a helper claims keep this call waiting, so calling from a worker
+    // job cannot deadlock.
+    const size_t helpers = std::min<size_t>(workers.threadCount(), packetCount > 0 ? packetCount - 1 : 0);
+    for (size_t i = 0; i < helpers; i++) workers.submit(work);
+    work();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->done.wait(lock, [&] { return batch->finishedPackets == packetCount; });
+    return batch->found;
+}
+
+Chunk* World::getChunk(int cx, int cz) {
+    return chunks.find(cx, cz);
+}
+
+const Chunk* World::getChunk(int cx, int cz) const {
+    return chunks.find(cx, cz);
+}
+
+int World::getSurfaceHeight(int gx, int gz) const {
+    const int cx = floorDiv(gx, CHUNK_SIZE);
+    const int cz = floorDiv(gz, CHUNK_SIZE);
+
+    const Chunk* chunk = chunks.find(cx, cz);
+    if (!chunk) return 0;
+    return chunk->getSurfaceHeight(gx - cx * CHUNK_SIZE, gz - cz * CHUNK_SIZE);
 }
 
 void World::regenerateAllChunks() {
-    for (auto& kv : chunks) {
-        auto& chunk = kv.second;
-        WorldGeneration::generateChunk(*chunk);
+    // Cached chunks hold terrain from the previous noise state, and so does any job
+    // still running; the new epoch makes their results stale. Edits are kept and
+    // replayed over the new terrain.
+    coldCache.clear();
+    farField.clear();
+    chunks.clear();
+    published.clear();
+    meshBytes = 0;
+    meshedChunks = 0;
+    unloadQueue.clear();
+    dirtyMeshes.clear();
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        loadQueue.clear();
     }
-    // After content changes, rebuild meshes with neighbor awareness
-    for (auto& kv : chunks) {
-        kv.second->generateMeshWithWorld(*this);
+    freshRequests.clear();
+    generating.clear();
+    generationEpoch++;
+
+    // Every observer keeps its interest; only the loads need issuing again
+    for (const auto& [id, observer] : observers) {
+        forEachEntering(nullptr, observer, 0, [&](int x, int z) { requestChunk(x, z, observer.center); });
     }
-}
\ No newline at end of file
+}
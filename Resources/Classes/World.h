@@ -1,28 +1,497 @@
 #pragma once
+#include "Camera.h"
 #include "Chunk.h"
-#include <unordered_map>
+#include "ChunkColdCache.h"
+#include "ChunkGrid.h"
+#include "ConcurrentChunkMap.h"
+#include "VoxelOctree.h"
+#include "LightEngine.h"
+#include "EditJournal.h"
+#include "ThreadPool.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <filesystem>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 #include <glm/glm.hpp>
 
+// Work in flight in the chunk pipeline
+struct StreamingStats {
+    size_t generating = 0;       // Chunks queued or running on the workers
+    size_t meshing = 0;          // Meshes queued or running on the workers
+    size_t uploadsWaiting = 0;   // Finished meshes held back by the upload budget
+    size_t uploadedChunks = 0;   // During the last update
+    size_t uploadedBytes = 0;    // During the last update
+    size_t unloadsWaiting = 0;   // Out of range chunks held back by the unload budget
+    size_t residentChunks = 0;
+
+    // Totals since the world was created
+    uint64_t loadedChunks = 0;
+    uint64_t unloadedChunks = 0;
+    // Loads of a chunk that was unloaded less than World::THRASH_WINDOW updates earlier
+    uint64_t reloadedChunks = 0;
+    // Mesher jobs started; close to one per loaded chunk when nothing is meshed twice
+    uint64_t meshesBuilt = 0;
+};
+
+// Memory held by resident chunks, against the ceilings set with World::setMemoryBudget
+struct MemoryStats {
+    size_t voxelBytes = 0;   // Blocks and light; see Chunk::voxelBytes
+    size_t meshBytes = 0;    // CPU mesh vertices
+    size_t voxelBudget = 0;  // 0 when unlimited
+    size_t meshBudget = 0;
+    size_t cachedChunks = 0; // Resident although no observer keeps them
+
+    // Totals since the world was created
+    uint64_t evictedChunks = 0; // Unloaded to stay within the voxel budget
+    uint64_t evictedMeshes = 0; // Dropped to stay within the mesh budget
+};
+
+// Chunks in each stage of the pipeline (see ChunkStage) and how long the steps into each
+// took. Timings count chunks that made it into the world; results thrown away because
+// every observer left, or because of regenerateAllChunks, are not included.
+struct PipelineStats {
+    struct Stage {
+        size_t chunks = 0;   // In this stage now; Requested counts chunks not resident yet
+        uint64_t timed = 0;  // Steps into this stage measured since the world was created
+        double totalMicros = 0.0;
+        double maxMicros = 0.0;
+
+        double averageMicros() const { return timed == 0 ? 0.0 : totalMicros / timed; }
+    };
+    std::array<Stage, CHUNK_STAGE_COUNT> stages;
+};
+
+// Shape of the region around each observer; see World::setResidencyShape
+enum class ResidencyShape {
+    Square, // Every chunk within the radius along both axes
+    Circle, // Every chunk whose center is within the radius plus half a chunk
+};
+
+// First solid block found by World::raycast
+struct RaycastHit {
+    glm::ivec3 block;
+    glm::ivec3 normal; // Face of the block the ray entered through, zero if it started inside
+    float distance;
+    BlockType type;
+};
+
+// One ray of World::raycastBatch; dir does not need to be normalized. A line of sight
+// from a to b is {a, b - a, distance(a, b)}.
+struct RayQuery {
+    glm::vec3 origin;
+    glm::vec3 dir;
+    float maxDist;
+};
+
+// A box of blocks from World::readRegion, indexed like Chunk::blockIndex: x is
+// contiguous, then z, then y, with the strides below. It either points into a chunk
+// section, which it keeps alive (later edits copy the section rather than change the
+// view), or into the caller's buffer.
+struct BlockRegionView {
+    const Block* data = nullptr; // Block at the box's min corner
+    glm::ivec3 size{0};
+    int rowStride = 0;   // Between consecutive z
+    int layerStride = 0; // Between consecutive y
+    std::shared_ptr<const ChunkSection> section; // nullptr when data is the caller's buffer
+
+    // Relative to the box's min corner; no bounds checks
+    Block at(int x, int y, int z) const { return data[y * layerStride + z * rowStride + x]; }
+    // The size.x blocks at z and y
+    std::span<const Block> row(int y, int z) const {
+        return {data + y * layerStride + z * rowStride, static_cast<size_t>(size.x)};
+    }
+    bool isZeroCopy() const { return section != nullptr; }
+};
+
 class World {
 public:
-    World();
+    // Chunks are generated, lit and meshed on workerThreads threads; the calling thread
+    // only stitches light across borders and installs finished meshes. With zero threads
+    // the same work runs inline inside update(). Nothing here touches the GPU: meshes are
+    // CPU vertex buffers that a renderer (see WorldRenderer) uploads.
+    // With a save directory, block edits are journaled there (see EditJournal) and
+    // replayed over the generated terrain when their chunks load again.
+    explicit World(unsigned workerThreads = ThreadPool::defaultThreadCount(),
+                   const std::filesystem::path& saveDirectory = {});
+    // Saves pending edits
+    ~World();
 
+    // Missing chunks are requested nearest first. With a view frustum, chunks the camera
+    // can see go ahead of the ones behind it; the order is recomputed every update.
+    // The player is an observer (see addObserver) with radius getLoadDistance(), whose
+    // window is also stretched along the view with a frustum (see setResidencyShape).
+    // Only chunks around the player are meshed and drawn.
     void update(const glm::vec3& playerPos);
-    void render() const;
+    void update(const glm::vec3& playerPos, const Frustum& view);
+    // Stream for the registered observers alone, as a server without a local player does
+    void update();
+
+    // Chunks with a mesh in the player's region, the ones a renderer should draw. Meshes
+    // outside it are not kept up to date.
+    template <typename Fn>
+    void forEachDrawableChunk(Fn&& fn) const {
+        chunks.forEach([&](const Chunk& chunk) {
+            if (chunk.hasMesh() && playerKeeps(chunk.position)) fn(chunk);
+        });
+    }
 
-    // Regenerate all currently loaded chunks (re-run noise and rebuild meshes)
+    // Interest regions sharing one set of resident chunks. Every chunk within radius
+    // chunks of an observer (in the residency shape) is loaded, and a chunk is unloaded
+    // only once no observer is within radius + UNLOAD_MARGIN of it.
+    // Moves take effect at the next update.
+    using ObserverId = uint32_t;
+    ObserverId addObserver(const glm::vec3& position, int radius);
+    void moveObserver(ObserverId id, const glm::vec3& position);
+    void removeObserver(ObserverId id);
+    size_t getObserverCount() const { return observers.size(); }
+    // Observers keeping the chunk loaded
+    uint32_t getInterest(int cx, int cz) const;
+    static constexpr int UNLOAD_MARGIN = 2;
+
+    // Circle (the default) leaves out the corners of the square, which are beyond the
+    // radius in every direction: about a fifth fewer resident chunks for the same range.
+    // With a view stretch s, the player's circle becomes an ellipse that reaches as far
+    // ahead and to the sides but only (1 - s) times as far behind, while update() gets a
+    // frustum. The view direction is snapped to VIEW_SECTORS directions so the window only
+    // changes when the camera turns that far. s is clamped to [0, MAX_VIEW_STRETCH].
+    void setResidencyShape(ResidencyShape shape, float viewStretch = 0.0f);
+    ResidencyShape getResidencyShape() const { return residencyShape; }
+    float getViewStretch() const { return viewStretch; }
+    static constexpr int VIEW_SECTORS = 16;
+    static constexpr float MAX_VIEW_STRETCH = 0.75f;
+
+    // Regenerate all currently loaded chunks (re-run noise and rebuild meshes).
+    // They stream back in through the pipeline like newly visited chunks.
     void regenerateAllChunks();
 
+    // Write edits made so far to disk. Done in the background every SAVE_INTERVAL,
+    // compacting the journal when it grows; no-op without a save directory.
+    void save();
+    static constexpr std::chrono::seconds SAVE_INTERVAL{5};
+
+    // Upper bound on meshes installed per update, which the renderer then uploads; at
+    // least one mesh is always installed
+    void setUploadBudget(size_t maxBytes, size_t maxChunks);
+    // Upper bound on chunks unloaded per update
+    void setUnloadBudget(size_t maxChunks);
+
+    // Ceilings on resident voxel data and on CPU mesh data, in bytes; 0 (the default) is
+    // no limit. Under a voxel budget, loads only start while there is room, best first, and
+    // chunks no observer keeps stay resident as a cache until their room is needed, least
+    // recently released first. When observers want more than fits, the chunks farthest
+    // from the player make way for nearer ones waiting to load, and are queued again.
+    // Over the mesh budget, meshes go down to 7/8 of it: first the ones outside the player's
+    // region, then the drawn ones farthest from the player. First meshes only start while
+    // an average one still fits, so dropped ones come back once there is room.
+    // Both ceilings hold after every update.
+    void setMemoryBudget(size_t maxVoxelBytes, size_t maxMeshBytes);
+
+    // Everything within renderDistance of the player (in the residency shape) is drawn.
+    // Chunks are loaded one ring further so each of those is meshed with all its neighbors
+    // present, and only unloaded past unloadDistance (UNLOAD_MARGIN further), so pacing
+    // across a chunk border does not reload whole rows.
+    int getRenderDistance() const { return renderDistance; }
+    int getLoadDistance() const { return loadDistance; }
+    int getUnloadDistance() const { return unloadDistance; }
+    static constexpr uint64_t THRASH_WINDOW = 600;
+
     // Get a block at global world coordinates (gx, gy, gz); returns AIR if missing
     Block getBlockGlobal(int gx, int gy, int gz) const;
+    // Change a block and relight around it; ignored if the chunk is not loaded
+    void setBlockGlobal(int gx, int gy, int gz, Block block);
+    // Packed sky/block light at global coordinates; unloaded chunks count as open sky
+    uint8_t getLightGlobal(int gx, int gy, int gz) const;
+    // Blocks in the half-open box [min, max), written to out in BlockRegionView order
+    // with no padding (row stride size.x, layer stride size.x * size.z). Unloaded chunks
+    // and layers outside the world read as AIR, like getBlockGlobal. Each chunk the box
+    // touches is looked up once and copied a row at a time. Returns false if out is
+    // smaller than the box.
+    bool copyRegion(const glm::ivec3& min, const glm::ivec3& max, std::span<Block> out) const;
+    // The same blocks without copying when the box lies inside one section of a loaded
+    // chunk; otherwise copyRegion into buffer, which must then hold the whole box.
+    // An empty view (null data) means buffer was too small.
+    BlockRegionView readRegion(const glm::ivec3& min, const glm::ivec3& max, std::span<Block> buffer) const;
+    // First solid block along the ray within maxDist; dir does not need to be normalized.
+    // Only loaded chunks are tested. Missing and empty chunks, the layers above and below a
+    // chunk's solid bounds and empty bricks (see Chunk::isBrickOccupied) are crossed in one
+    // step each, so open space costs little however far the ray goes.
+    bool raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDist, RaycastHit& hit) const;
+    // raycast for every ray against the published chunks (see getPublishedChunk), so edits
+    // made since the last update are not seen yet. hits[i] is for rays[i], with type AIR
+    // if the ray hit nothing; returns how many hit something. Rays leaving the same chunk
+    // in the same direction quadrant are traced as a packet that walks the chunks
+    // together, looking each one up once for all of its rays. The calling thread and the
+    // worker threads share out the packets, and the call returns once all are done.
+    // May be called from any thread, including a worker job.
+    size_t raycastBatch(std::span<const RayQuery> rays, std::span<RaycastHit> hits);
+
+    // Queue a loaded chunk for remeshing; repeated calls before the next update are free.
+    // Edits made through World and LightEngine call this; direct Chunk edits must too.
+    void markMeshDirty(Chunk& chunk) {
+        // Whatever mesh it has no longer matches its blocks
+        if (chunk.stage > ChunkStage::Lit) chunk.stage = ChunkStage::Lit;
+        if (chunk.needsMeshUpdate) return;
+        chunk.needsMeshUpdate = true;
+        dirtyMeshes.push_back(chunk.position);
+    }
+    void markMeshDirty(int cx, int cz) {
+        if (Chunk* chunk = chunks.find(cx, cz)) markMeshDirty(*chunk);
+    }
+
+    // Loaded chunk at chunk coordinates, or nullptr
+    Chunk* getChunk(int cx, int cz);
+    const Chunk* getChunk(int cx, int cz) const;
+    // The chunk as of the last update, or nullptr if it was not loaded then. Safe to call
+    // from any thread, and what it returns stays valid after the chunk unloads.
+    std::shared_ptr<const ChunkSnapshot> getPublishedChunk(int cx, int cz) const { return published.find(cx, cz); }
+    // One past the highest solid block in the column at (gx, gz); 0 if empty or not loaded
+    int getSurfaceHeight(int gx, int gz) const;
+
+    const ChunkColdCache& getColdCache() const { return coldCache; }
+    // nullptr without a save directory
+    const EditJournal* getEditJournal() const { return editJournal.get(); }
+    // Shape of every chunk that has left the render distance, for distant queries
+    const VoxelOctree& getFarField() const { return farField; }
+    const LightStats& getLightStats() const { return lightEngine.getStats(); }
+    StreamingStats getStreamingStats() const;
+    MemoryStats getMemoryStats() const;
+    PipelineStats getPipelineStats() const;
+    // Stage of the chunk at chunk coordinates; nullopt if it is neither loaded nor requested
+    std::optional<ChunkStage> getChunkStage(int cx, int cz) const;
 
 private:
-    std::unordered_map<int64_t, std::unique_ptr<Chunk>> chunks;
     int renderDistance;
+    int loadDistance;
+    int unloadDistance;
+    // Everything some observer keeps, and whatever has not been unloaded yet. The grid
+    // window is sized for the player; other observers' chunks mostly live in its overflow.
+    ChunkGrid chunks;
+    // Snapshots of the resident chunks for worker jobs, which must not touch chunks. A
+    // chunk is published again when it is in the mesh dirty set at an update, which every
+    // edit puts it in, and its contents changed since it was last published (see
+    // Chunk::getContentRevision). It is retired when it unloads.
+    ConcurrentChunkMap published;
+
+    // Chunks between unloadDistance and coldDistance (in the residency shape, around the
+    // player) are kept compressed in RAM
+    int coldDistance;
+    ChunkColdCache coldCache;
+
+    struct Observer {
+        glm::ivec2 center; // Chunk the observer is in
+        int radius;
+        // The player's view direction in the xz plane, snapped to a sector, and the view
+        // stretch applied along it; 0 for everyone else
+        glm::vec2 forward{1.0f, 0.0f};
+        float stretch = 0.0f;
+    };
+    ResidencyShape residencyShape = ResidencyShape::Circle;
+    float viewStretch = 0.0f;
+    std::unordered_map<ObserverId, Observer> observers;
+    ObserverId nextObserverId = 0;
+    // The observer update(playerPos) moves, registered by its first call
+    ObserverId playerObserver = 0;
+    bool hasPlayer = false;
+    // The player's observer as of the last move
+    Observer player{{0, 0}, 0};
+    // Observers whose region (radius + UNLOAD_MARGIN) covers each chunk; absent means none.
+    // Only the strips an observer moves onto and off are counted, so standing still is free.
+    std::unordered_map<int64_t, uint32_t> interest;
+    // Resident chunks no observer keeps any more, in release order, waiting for the unload
+    // budget or, under a voxel budget, for their room to be needed. Entries whose chunk was
+    // wanted again or released again since are skipped.
+    struct ReleasedChunk {
+        glm::ivec2 position;
+        uint64_t serial; // Chunk::releaseSerial when it was queued
+    };
+    std::deque<ReleasedChunk> unloadQueue;
+    uint64_t releaseCount = 0;
+    size_t unloadBudget = 8;
+    // Update count at which each chunk was last unloaded, for the thrash counter
+    std::unordered_map<int64_t, uint64_t> recentlyUnloaded;
+    uint64_t updateCount = 0;
+    uint64_t loadedChunks = 0;
+    uint64_t unloadedChunks = 0;
+    uint64_t reloadedChunks = 0;
+    uint64_t meshesBuilt = 0;
+
+    // See setMemoryBudget; 0 is no limit
+    size_t voxelBudgetBytes = 0;
+    size_t meshBudgetBytes = 0;
+    // Installed meshes of resident chunks
+    size_t meshBytes = 0;
+    size_t meshedChunks = 0;
+    // Set when first meshes were held back by the mesh budget during the last update
+    bool meshesWaitingForRoom = false;
+    uint64_t evictedChunks = 0;
+    uint64_t evictedMeshes = 0;
+
+    VoxelOctree farField;
+    LightEngine lightEngine;
+
+    // Block edits, written to disk by a worker job
+    std::unique_ptr<EditJournal> editJournal;
+    std::atomic<bool> flushRunning{false};
+    std::chrono::steady_clock::time_point lastFlush = std::chrono::steady_clock::now();
+
+    // Work handed to and back from worker jobs, guarded by resultMutex
+    struct GeneratedChunk {
+        std::unique_ptr<Chunk> chunk;
+        std::array<uint8_t, CHUNK_VOLUME> light;
+        uint32_t epoch;
+    };
+    struct BuiltMesh {
+        glm::ivec2 position;
+        uint64_t ticket; // Matches Chunk::meshTicket unless the chunk was unloaded since
+        std::vector<float> vertices;
+        float buildMicros = 0.0f;
+        std::chrono::steady_clock::time_point built{};
+    };
+    struct LoadRequest {
+        glm::ivec2 position;
+        float priority;
+        uint32_t epoch;
+        std::vector<uint8_t> packed; // Cold cache entry, empty if the chunk must be generated
+        std::chrono::steady_clock::time_point requested = std::chrono::steady_clock::now();
+    };
+    struct LoadOrder {
+        bool operator()(const LoadRequest& a, const LoadRequest& b) const { return a.priority > b.priority; }
+    };
+
+    // Guards the three queues below and queuedLoadJobs
+    mutable std::mutex resultMutex;
+    std::vector<GeneratedChunk> generatedChunks;
+    std::deque<BuiltMesh> builtMeshes;
+    // Requested chunks no job has started on yet, a min-heap on priority. Jobs pop the
+    // best request when they start rather than when they are submitted, and update()
+    // rescores the heap, so turning the camera reorders everything still waiting.
+    std::vector<LoadRequest> loadQueue;
+    // Load jobs submitted that have not taken a request yet. Requests beyond these wait
+    // for a job, which under a voxel budget only starts when there is room.
+    size_t queuedLoadJobs = 0;
+
+    // Chunks queued, being built or waiting to be integrated, and the epoch they were
+    // requested in. regenerateAllChunks bumps the epoch so results from the old noise are dropped.
+    std::unordered_map<int64_t, uint32_t> generating;
+    uint32_t generationEpoch = 0;
+    // Chunks that entered observers' load windows since the last update, not queued yet.
+    // Update thread only.
+    std::vector<LoadRequest> freshRequests;
+    // Chunks with needsMeshUpdate set, each listed once. Entries whose chunk was unloaded
+    // or already meshed are skipped when the set is drained.
+    std::vector<glm::ivec2> dirtyMeshes;
+    uint64_t nextMeshTicket = 0;
+    size_t meshJobs = 0;
+
+    // Load order inputs from the last update; see loadPriority
+    glm::vec3 viewPosition{0.0f};
+    Frustum viewFrustum;
+    bool hasViewFrustum = false;
+
+    // Stage timings of chunks taken in so far; the counts are filled in by getPipelineStats
+    PipelineStats pipeline;
+
+    size_t uploadBudgetBytes = 4 * 1024 * 1024;
+    size_t uploadBudgetChunks = 8;
+    size_t lastUploadedChunks = 0;
+    size_t lastUploadedBytes = 0;
+
+    // Declared last so it is destroyed first: jobs write into the members above
+    ThreadPool workers;
+
+    static int64_t chunkKey(int x, int z);
 
-    int64_t getChunkKey(int x, int z) const;
-    
-    void loadChunk(int x, int z);
-    void unloadDistantChunks(const glm::vec3& playerPos);
+    // A ray part way through the chunk grid; see raycast
+    struct RayState {
+        glm::vec3 origin;
+        glm::vec3 dir; // Normalized
+        glm::vec3 invDir;
+        glm::ivec3 step;
+        glm::ivec3 cell;
+        glm::ivec3 normal; // Face cell was entered through
+        float t;           // Distance at which cell was entered
+        float tEnd;
+    };
+    enum class RayStep { Hit, Miss, NextChunk };
+    // Rays per packet in raycastBatch
+    static constexpr size_t PACKET_RAYS = 64;
+    // False if the ray never reaches the chunk layers within maxDist
+    static bool startRay(const glm::vec3& origin, const glm::vec3& dir, float maxDist, RayState& ray);
+    // Follow the ray through the chunk column at position (chunk is nullptr if not loaded)
+    // until it hits a block, ends, or crosses into the next column. ChunkData is Chunk or
+    // ChunkSnapshot.
+    template <typename ChunkData>
+    static RayStep marchChunk(RayState& ray, const ChunkData* chunk, const glm::ivec2& position, RaycastHit& hit);
+    // Trace rays[rayIndices[i]] together into hits[rayIndices[i]] through the published
+    // chunks; returns how many hit
+    size_t tracePacket(std::span<const RayQuery> rays, std::span<const uint32_t> rayIndices,
+                       std::span<RaycastHit> hits) const;
+    // Chunks of column x within radius + extra of the observer, in the residency shape:
+    // [first, last] on z, empty when first > last. Every shape is convex, so a column
+    // holds a single run.
+    std::pair<int, int> windowColumn(const Observer& observer, int extra, int x) const;
+    // How many columns the window reaches to either side of the observer's
+    int windowExtent(const Observer& observer, int extra) const;
+    bool inWindow(const Observer& observer, int extra, int x, int z) const;
+    // Within coldDistance of the player's chunk, in the residency shape
+    bool inColdRing(const glm::ivec2& playerCenter, const glm::ivec2& position) const {
+        return inWindow(Observer{playerCenter, coldDistance}, 0, position.x, position.y);
+    }
+    // Visit the chunks within radius + extra of next that were not within radius + extra of
+    // previous. Without a previous window, every chunk is visited.
+    template <typename Fn>
+    void forEachEntering(const Observer* previous, const Observer& next, int extra, Fn&& fn) const;
+    // Within the player's region, where chunks are meshed and drawn
+    bool playerKeeps(const glm::ivec2& position) const {
+        return hasPlayer && inWindow(player, UNLOAD_MARGIN, position.x, position.y);
+    }
+    static glm::ivec2 chunkOf(const glm::vec3& position);
+    // Lower loads first: distance in chunks, pushed behind everything in view when the
+    // chunk is outside the frustum. The chunks around the player are never pushed back.
+    float loadPriority(const glm::ivec2& position) const;
+    void movePlayer(const glm::vec3& playerPos);
+    void streamChunks();
+    // Move or reshape the observer to next: count it in on the chunks its region took on,
+    // release the ones it left, and request the chunks that entered its load window
+    void shiftObserver(Observer& observer, const Observer& next, bool placed);
+    void releaseInterest(int cx, int cz);
+    // Queue a load unless the chunk is resident or pending; a resident chunk entering
+    // the player's window without a mesh is queued for meshing instead
+    void requestChunk(int cx, int cz, const glm::ivec2& observerCenter);
+    // Rescore the load queue, drop what no observer wants and start jobs for waiting
+    // requests, as far as the voxel budget allows
+    void requestChunks();
+    // Worker side: build the best request in the load queue, if any is left
+    void loadNextChunk();
+    // Insert finished chunks, stitch their light and flag meshes for rebuilding
+    void integrateGeneratedChunks();
+    // Drain the dirty set: start mesher jobs for chunks whose neighbors are all loaded
+    void scheduleMeshing();
+    // Install finished meshes within the per-update budget
+    void uploadMeshes();
+    // True once the neighbors STAGE_DEPENDENCIES lists for stage are resident and have
+    // reached the stage it asks for
+    bool neighborsReached(const glm::ivec2& position, ChunkStage stage) const;
+    // Count the chunk's time for the step into stage in the pipeline totals
+    void recordStage(const Chunk& chunk, ChunkStage stage);
+    // Drop meshes over the mesh budget
+    void evictMeshes();
+    // Unload released chunks within the budget; under a voxel budget, only those whose
+    // room is needed, and wanted ones if that is not enough
+    void unloadReleasedChunks();
+    // Unload chunks observers want, farthest from the player first, while over the voxel
+    // budget or while a clearly nearer chunk waits for room, and request them again
+    void evictWantedChunks(size_t maxChunks);
+    // Keep a leaving chunk in the far field, and in the cold cache if it is near the player
+    void unloadChunk(std::unique_ptr<Chunk> chunk);
+    // Write edits to disk on a worker if the last flush is old enough
+    void scheduleFlush();
 };
\ No newline at end of file
@@ -1,9 +1,10 @@
 #include "WorldGeneration.h"
 #include <cmath>
+#include <mutex>
 
 std::unique_ptr<PerlinNoise> WorldGeneration::perlin = nullptr;
 unsigned int WorldGeneration::currentSeed = 0;
-float WorldGeneration::animationTime = 0.0f;
+std::atomic<float> WorldGeneration::animationTime = 0.0f;
 
 void WorldGeneration::initialize(unsigned int seed) {
     currentSeed = seed;
@@ -30,12 +31,24 @@ float WorldGeneration::getCaveDensity(float x, float y, float z) {
 }
 
 void WorldGeneration::generateChunk(Chunk& chunk) {
-    if (!perlin) initialize();
-    
+    // Default seed on first use; once, however many workers get here together
+    static std::once_flag defaultSeed;
+    std::call_once(defaultSeed, [] {
+        if (!perlin) initialize();
+    });
+
     const glm::ivec2 chunkPos = chunk.position;
     const int worldX = chunkPos.x * CHUNK_SIZE;
     const int worldZ = chunkPos.y * CHUNK_SIZE;
-    
+
+    // Every voxel is overwritten below, so write straight into the section storage.
+    // The column data is rebuilt once the edit goes out of scope.
+    Chunk::BlockEdit edit = chunk.editBlocks();
+    Block* sections[CHUNK_SECTIONS];
+    for (int i = 0; i < CHUNK_SECTIONS; i++) {
+        sections[i] = edit.section(i).data();
+    }
+
     for (int x = 0; x < CHUNK_SIZE; x++) {
         for (int z = 0; z < CHUNK_SIZE; z++) {
             const float globalX = worldX + x;
@@ -62,9 +75,9 @@ void WorldGeneration::generateChunk(Chunk& chunk) {
                     // Air above surface and in deliberately empty top layers
                     block.type = BlockType::AIR;
                 }
-                
-                chunk.setBlock(x, y, z, block);
+
+                sections[y / SECTION_HEIGHT][Chunk::blockIndex(x, y % SECTION_HEIGHT, z)] = block;
             }
         }
     }
-}
\ No newline at end of file
+}
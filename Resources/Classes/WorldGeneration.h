@@ -1,8 +1,11 @@
 #pragma once
 #include "Chunk.h"
 #include "PerlinNoise.h"
+#include <atomic>
 #include <memory>
 
+// generateChunk may run on several worker threads at once. initialize() must not be
+// called while chunks are being generated; setAnimationTime() may.
 class WorldGeneration {
 public:
     static void initialize(unsigned int seed = 0);
@@ -14,7 +17,7 @@ public:
 private:
     static std::unique_ptr<PerlinNoise> perlin;
     static unsigned int currentSeed;
-    static float animationTime;
+    static std::atomic<float> animationTime;
 
     static constexpr float TERRAIN_SCALE = 0.01f;
     static constexpr float CAVE_SCALE = 0.05f;
@@ -0,0 +1,67 @@
+#include "WorldRenderer.h"
+#include "ChunkMesher.h"
+#include "Lib/Glad/include/glad/glad.h"
+
+WorldRenderer::~WorldRenderer() {
+    for (auto& [key, mesh] : meshes) release(mesh);
+}
+
+void WorldRenderer::render(const World& world) {
+    frame++;
+    lastUploadedBytes = 0;
+
+    world.forEachDrawableChunk([&](const Chunk& chunk) {
+        const int64_t key = (static_cast<int64_t>(chunk.position.x) << 32) | static_cast<uint32_t>(chunk.position.y);
+        GpuMesh& mesh = meshes[key];
+        mesh.lastFrame = frame;
+        if (mesh.revision != chunk.getMeshRevision()) {
+            upload(mesh, chunk.getMeshVertices());
+            mesh.revision = chunk.getMeshRevision();
+            lastUploadedBytes += chunk.getMeshVertices().size() * sizeof(float);
+        }
+        if (mesh.vertexCount == 0) return;
+
+        glBindVertexArray(mesh.VAO);
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(mesh.vertexCount));
+    });
+
+    // Chunks that were unloaded or left the player's region
+    for (auto it = meshes.begin(); it != meshes.end();) {
+        if (it->second.lastFrame == frame) {
+            ++it;
+            continue;
+        }
+        release(it->second);
+        it = meshes.erase(it);
+    }
+}
+
+void WorldRenderer::upload(GpuMesh& mesh, const std::vector<float>& vertices) {
+    if (mesh.VAO == 0) {
+        glGenVertexArrays(1, &mesh.VAO);
+        glGenBuffers(1, &mesh.VBO);
+    }
+
+    glBindVertexArray(mesh.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+
+    // Vertex attributes (position + normal + color + sky/block light)
+    const GLsizei stride = ChunkMesher::VERTEX_FLOATS * sizeof(float);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, (void*)(9 * sizeof(float)));
+    glEnableVertexAttribArray(3);
+
+    mesh.vertexCount = vertices.size() / ChunkMesher::VERTEX_FLOATS;
+}
+
+void WorldRenderer::release(GpuMesh& mesh) {
+    if (mesh.VBO != 0) glDeleteBuffers(1, &mesh.VBO);
+    if (mesh.VAO != 0) glDeleteVertexArrays(1, &mesh.VAO);
+    mesh = GpuMesh{};
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "World.h"
+#include <cstdint>
+#include <unordered_map>
+
+// GPU side of a World: one vertex array per drawn chunk, uploaded from the chunk's CPU
+// mesh whenever its revision changes and freed once the chunk stops being drawn.
+// The world's upload budget limits how many meshes it installs per update, and with
+// that how many are uploaded per frame. GL thread only.
+class WorldRenderer {
+public:
+    WorldRenderer() = default;
+    ~WorldRenderer();
+
+    WorldRenderer(const WorldRenderer&) = delete;
+    WorldRenderer& operator=(const WorldRenderer&) = delete;
+
+    void render(const World& world);
+
+    size_t bufferCount() const { return meshes.size(); }
+    // Bytes uploaded by the last render
+    size_t uploadedBytes() const { return lastUploadedBytes; }
+
+private:
+    struct GpuMesh {
+        unsigned int VAO = 0;
+        unsigned int VBO = 0;
+        size_t vertexCount = 0;
+        uint64_t revision = 0;  // Chunk::getMeshRevision of the uploaded copy
+        uint64_t lastFrame = 0; // Freed when a frame passes without drawing it
+    };
+
+    std::unordered_map<int64_t, GpuMesh> meshes;
+    uint64_t frame = 0;
+    size_t lastUploadedBytes = 0;
+
+    static void upload(GpuMesh& mesh, const std::vector<float>& vertices);
+    static void release(GpuMesh& mesh);
+};
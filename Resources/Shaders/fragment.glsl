@@ -2,6 +2,7 @@
 in vec3 FragPos;
 in vec3 Normal;
 in vec3 Color;
+in vec2 Light; // Baked sky light (x) and block light (y), 0-1
 
 out vec4 FragColor;
 
@@ -13,7 +14,11 @@ void main() {
     float diff = max(dot(norm, -lightDir), 0.0);
     float diffuse = 0.7 * diff;
 
-    vec3 lit = Color * (ambient + diffuse);
+    // Each light level is 80% as bright as the one above it
+    float sky = pow(0.8, 15.0 * (1.0 - Light.x));
+    float block = pow(0.8, 15.0 * (1.0 - Light.y)) * step(0.001, Light.y);
+    float brightness = max(sky * (ambient + diffuse), block);
+
+    vec3 lit = Color * max(brightness, 0.03);
     FragColor = vec4(lit, 1.0);
 }
-
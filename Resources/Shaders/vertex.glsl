@@ -2,10 +2,12 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec3 aColor;
+layout (location = 3) in vec2 aLight;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec3 Color;
+out vec2 Light;
 
 uniform mat4 model;
 uniform mat4 view;
@@ -15,5 +17,6 @@ void main() {
     FragPos = vec3(model * vec4(aPos, 1.0));
     Normal = mat3(transpose(inverse(model))) * aNormal;
     Color = aColor;
+    Light = aLight;
     gl_Position = projection * view * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+}
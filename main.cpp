@@ -5,7 +5,9 @@
 #include "Resources/Classes/Shader.h"
 #include "Resources/Classes/Camera.h"
 #include "Resources/Classes/World.h"
+#include "Resources/Classes/WorldRenderer.h"
 #include "Resources/Classes/WorldGeneration.h"
+#include "Resources/Classes/FrameStats.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
@@ -74,7 +76,8 @@ int main() {
     // 6. Initialize engine components
     try {
         Shader shader("Resources/Shaders/vertex.glsl", "Resources/Shaders/fragment.glsl");
-        World world;
+        World world(ThreadPool::defaultThreadCount(), "Saves/world");
+        WorldRenderer renderer;
         Camera camera(glm::vec3(0.0f, 0.0f, 3.0f));
 
         // Provide camera to callbacks and enable mouse-look
@@ -99,6 +102,7 @@ int main() {
 
         // 7. Main render loop
         static bool wireframeMode = false; // Declare wireframe state outside loop
+        FrameStats frameStats;
 
         while (!glfwWindowShouldClose(window)) {
             // Input
@@ -114,8 +118,6 @@ int main() {
             }
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-            // Update and render
-            world.update(camera.Position);
             float currentFrame = glfwGetTime();
             static float lastFrame = 0.0f;
             static int frames = 0;
@@ -124,6 +126,8 @@ int main() {
             float deltaTime = currentFrame - lastFrame;
             lastFrame = currentFrame;
 
+            frameStats.addFrame(deltaTime * 1000.0);
+
             // Advance noise time slowly (terrain evolves conceptually)
             noiseTime += deltaTime * 0.25f;
 
@@ -134,7 +138,22 @@ int main() {
                 int fps = frames;
                 frames = 0;
                 fpsTimer = 0.0f;
-                std::string title = "Voxel Engine - FPS: " + std::to_string(fps);
+                const ChunkColdCache& cold = world.getColdCache();
+                const LightStats& light = world.getLightStats();
+                const StreamingStats streaming = world.getStreamingStats();
+                const MemoryStats memory = world.getMemoryStats();
+                std::string title = "Voxel Engine - FPS: " + std::to_string(fps) +
+                                    ", p99 " + std::to_string(static_cast<int>(frameStats.percentile(0.99))) + " ms" +
+                                    " | Pending: " + std::to_string(streaming.generating) + " gen, " +
+                                    std::to_string(streaming.meshing + streaming.uploadsWaiting) + " mesh, " +
+                                    std::to_string(streaming.unloadsWaiting) + " unload" +
+                                    " | Reloads: " + std::to_string(streaming.reloadedChunks) +
+                                    " | Memory: " + std::to_string(memory.voxelBytes / (1024 * 1024)) + " MB voxels, " +
+                                    std::to_string(memory.meshBytes / (1024 * 1024)) + " MB meshes" +
+                                    " | Cold: " + std::to_string(cold.entryCount()) + " chunks, " +
+                                    std::to_string(cold.sizeBytes() / 1024) + " KB, hit " +
+                                    std::to_string(static_cast<int>(cold.hitRate() * 100.0f)) + "%" +
+                                    " | Light: " + std::to_string(static_cast<int>(light.lastMicros)) + " us";
                 glfwSetWindowTitle(window, title.c_str());
             }
 
@@ -168,6 +187,21 @@ int main() {
                 }
             }
             wireframePressedLast = wireframePressed;
+
+            // Dump where chunks are in the pipeline and how long each stage takes with 'P'
+            static bool pipelinePressedLast = false;
+            bool pipelinePressed = (glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS);
+            if (pipelinePressed && !pipelinePressedLast) {
+                const PipelineStats pipeline = world.getPipelineStats();
+                std::cout << "Chunk pipeline:" << std::endl;
+                for (int i = 0; i < CHUNK_STAGE_COUNT; i++) {
+                    const PipelineStats::Stage& stage = pipeline.stages[i];
+                    std::cout << "  " << CHUNK_STAGE_NAMES[i] << ": " << stage.chunks << " chunks, avg "
+                              << static_cast<int>(stage.averageMicros()) << " us, max "
+                              << static_cast<int>(stage.maxMicros) << " us" << std::endl;
+                }
+            }
+            pipelinePressedLast = pipelinePressed;
             if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
                 camera.ProcessKeyboard(Camera_Movement::BACKWARD, deltaTime);
             if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
@@ -179,6 +213,25 @@ int main() {
             if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS || glfwGetKey(window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS)
                 camera.ProcessKeyboard(Camera_Movement::DOWN, deltaTime);
 
+            // Left click breaks the block under the crosshair, right click places stone against it
+            static bool breakPressedLast = false;
+            static bool placePressedLast = false;
+            bool breakPressed = (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS);
+            bool placePressed = (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS);
+            if ((breakPressed && !breakPressedLast) || (placePressed && !placePressedLast)) {
+                RaycastHit hit;
+                if (world.raycast(camera.Position, camera.Front, 8.0f, hit)) {
+                    if (breakPressed) {
+                        world.setBlockGlobal(hit.block.x, hit.block.y, hit.block.z, Block{BlockType::AIR});
+                    } else if (hit.normal != glm::ivec3(0)) {
+                        const glm::ivec3 target = hit.block + hit.normal;
+                        world.setBlockGlobal(target.x, target.y, target.z, Block{BlockType::STONE});
+                    }
+                }
+            }
+            breakPressedLast = breakPressed;
+            placePressedLast = placePressed;
+
             // Create projection matrix from current framebuffer size
             int fbw = 800, fbh = 600;
             glfwGetFramebufferSize(window, &fbw, &fbh);
@@ -188,6 +241,10 @@ int main() {
             // Get view matrix from camera
             glm::mat4 view = camera.GetViewMatrix();
 
+            // Stream chunks, loading what the camera faces first
+            camera.UpdateFrustum(projection * view);
+            world.update(camera.Position, camera.frustum);
+
             // Use shader and pass matrices as uniforms
             shader.use();
             shader.setMat4("projection", projection);
@@ -195,7 +252,7 @@ int main() {
             shader.setMat4("model", glm::mat4(1.0f));
 
             // Now render world
-            world.render();
+            renderer.render(world);
 
             // Swap buffers
             glfwSwapBuffers(window);